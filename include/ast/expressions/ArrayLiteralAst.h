@@ -10,6 +10,9 @@ public:
   explicit ArrayLiteralAst(antlr4::Token *token) : Ast(token), ExpressionAst(token) {}
   void addElement(std::shared_ptr<ExpressionAst> element);
   std::vector<std::shared_ptr<ExpressionAst>> getElements() const { return elements; }
+  void setElements(const std::vector<std::shared_ptr<ExpressionAst>> &elements_) {
+    elements = elements_;
+  }
 
   NodeType getNodeType() const override;
   std::string toStringTree(std::string prefix) const override;
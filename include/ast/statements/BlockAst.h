@@ -10,6 +10,7 @@ public:
 
   std::vector<std::shared_ptr<Ast>> getChildren() const;
   void addChildren(std::shared_ptr<Ast> child);
+  void setChildren(const std::vector<std::shared_ptr<Ast>> &children_);
 
   NodeType getNodeType() const override;
   std::string toStringTree(std::string prefix) const override;
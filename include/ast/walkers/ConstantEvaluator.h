@@ -0,0 +1,64 @@
+#pragma once
+#include "AstWalker.h"
+#include "utils/ConstantFoldingUtils.h"
+
+#include <unordered_map>
+
+namespace gazprea::ast::walkers {
+// Interprets calls to Gazprea functions whose arguments are all known at compile time. Functions
+// are pure, so the result of such a call can replace it. Evaluation gives up (and the call is left
+// for runtime) on anything it does not model: non-scalar values, statements other than plain
+// control flow and assignment, operations that raise at runtime, or running out of fuel.
+class ConstantEvaluator final : public AstWalker {
+  enum class Flow { Normal, Break, Continue, Return };
+  using Frame = std::unordered_map<symTable::Symbol *, utils::ConstantValue>;
+
+  const std::unordered_map<symTable::Symbol *, std::shared_ptr<expressions::ExpressionAst>>
+      &constValues;
+  std::vector<Frame> frames;
+  std::optional<utils::ConstantValue> returnValue;
+  size_t fuel = 0;
+
+  void consumeFuel();
+  utils::ConstantValue evaluate(const std::shared_ptr<expressions::ExpressionAst> &expr);
+  Flow execute(const std::shared_ptr<Ast> &statement);
+  bool evaluateCondition(const std::shared_ptr<expressions::ExpressionAst> &condition);
+  utils::ConstantValue call(const std::shared_ptr<symTable::Symbol> &callee,
+                            const std::vector<utils::ConstantValue> &args);
+
+public:
+  // Upper bound on the statements, loop iterations and calls a single evaluation may run
+  static constexpr size_t kEvaluationFuel = 1 << 20;
+  static constexpr size_t kMaxCallDepth = 256;
+
+  explicit ConstantEvaluator(
+      const std::unordered_map<symTable::Symbol *, std::shared_ptr<expressions::ExpressionAst>>
+          &constValues)
+      : constValues(constValues) {};
+  ~ConstantEvaluator() override = default;
+
+  // Result of calling `callee` with `args`, or nullopt if it cannot be computed at compile time
+  std::optional<utils::ConstantValue> evaluateCall(const std::shared_ptr<symTable::Symbol> &callee,
+                                                   const std::vector<utils::ConstantValue> &args);
+
+  std::any visitBlock(std::shared_ptr<statements::BlockAst> ctx) override;
+  std::any visitDeclaration(std::shared_ptr<statements::DeclarationAst> ctx) override;
+  std::any visitAssignment(std::shared_ptr<statements::AssignmentAst> ctx) override;
+  std::any visitReturn(std::shared_ptr<statements::ReturnAst> ctx) override;
+  std::any visitConditional(std::shared_ptr<statements::ConditionalAst> ctx) override;
+  std::any visitLoop(std::shared_ptr<statements::LoopAst> ctx) override;
+  std::any visitBreak(std::shared_ptr<statements::BreakAst> ctx) override;
+  std::any visitContinue(std::shared_ptr<statements::ContinueAst> ctx) override;
+  std::any
+  visitStructFuncCallRouter(std::shared_ptr<expressions::StructFuncCallRouterAst> ctx) override;
+  std::any visitFuncProcCall(std::shared_ptr<expressions::FuncProcCallAst> ctx) override;
+  std::any visitBinary(std::shared_ptr<expressions::BinaryAst> ctx) override;
+  std::any visitUnary(std::shared_ptr<expressions::UnaryAst> ctx) override;
+  std::any visitCast(std::shared_ptr<expressions::CastAst> ctx) override;
+  std::any visitIdentifier(std::shared_ptr<expressions::IdentifierAst> ctx) override;
+  std::any visitInteger(std::shared_ptr<expressions::IntegerLiteralAst> ctx) override;
+  std::any visitReal(std::shared_ptr<expressions::RealLiteralAst> ctx) override;
+  std::any visitChar(std::shared_ptr<expressions::CharLiteralAst> ctx) override;
+  std::any visitBool(std::shared_ptr<expressions::BoolLiteralAst> ctx) override;
+};
+} // namespace gazprea::ast::walkers
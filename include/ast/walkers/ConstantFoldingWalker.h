@@ -0,0 +1,56 @@
+#pragma once
+#include "AstWalker.h"
+#include "symTable/SymTable.h"
+#include "utils/ConstantFoldingUtils.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace gazprea::ast::walkers {
+// Rewrites scalar expressions whose value is known at compile time into literals, including calls
+// to functions with constant arguments, and removes the statements a constant condition can never
+// run. Anything that has to fail at runtime (division by zero, out of range casts) is left untouched
+// for the backend.
+class ConstantFoldingWalker final : public AstWalker {
+  std::shared_ptr<symTable::SymbolTable> symTab;
+  // Literal initializer of every const variable whose declaration folded to one
+  std::unordered_map<symTable::Symbol *, std::shared_ptr<expressions::ExpressionAst>> constValues;
+  // Variables written by an input statement, whose initializer is never propagated
+  std::unordered_set<symTable::Symbol *> inputTargets;
+
+  std::shared_ptr<expressions::ExpressionAst>
+  fold(const std::shared_ptr<expressions::ExpressionAst> &expr);
+  void visitArgs(const std::vector<std::shared_ptr<expressions::ArgAst>> &args);
+  // Literal result of a call to a pure function with constant arguments, or nullptr
+  std::shared_ptr<expressions::ExpressionAst>
+  evaluateCall(const std::shared_ptr<expressions::FuncProcCallAst> &call,
+               const std::shared_ptr<expressions::ExpressionAst> &replaced);
+
+public:
+  explicit ConstantFoldingWalker(std::shared_ptr<symTable::SymbolTable> symTab) : symTab(symTab) {};
+  ~ConstantFoldingWalker() override = default;
+  std::any visitRoot(std::shared_ptr<RootAst> ctx) override;
+  std::any visitFunction(std::shared_ptr<prototypes::FunctionAst> ctx) override;
+  std::any visitProcedure(std::shared_ptr<prototypes::ProcedureAst> ctx) override;
+  std::any visitBlock(std::shared_ptr<statements::BlockAst> ctx) override;
+  std::any visitDeclaration(std::shared_ptr<statements::DeclarationAst> ctx) override;
+  std::any visitAssignment(std::shared_ptr<statements::AssignmentAst> ctx) override;
+  std::any visitOutput(std::shared_ptr<statements::OutputAst> ctx) override;
+  std::any visitReturn(std::shared_ptr<statements::ReturnAst> ctx) override;
+  std::any visitConditional(std::shared_ptr<statements::ConditionalAst> ctx) override;
+  std::any visitLoop(std::shared_ptr<statements::LoopAst> ctx) override;
+  std::any visitIteratorLoop(std::shared_ptr<statements::IteratorLoopAst> ctx) override;
+  std::any visitProcedureCall(std::shared_ptr<statements::ProcedureCallAst> ctx) override;
+  std::any visitFuncProcCall(std::shared_ptr<expressions::FuncProcCallAst> ctx) override;
+  std::any
+  visitStructFuncCallRouter(std::shared_ptr<expressions::StructFuncCallRouterAst> ctx) override;
+  std::any visitArg(std::shared_ptr<expressions::ArgAst> ctx) override;
+  std::any visitBinary(std::shared_ptr<expressions::BinaryAst> ctx) override;
+  std::any visitUnary(std::shared_ptr<expressions::UnaryAst> ctx) override;
+  std::any visitCast(std::shared_ptr<expressions::CastAst> ctx) override;
+  std::any visitIdentifier(std::shared_ptr<expressions::IdentifierAst> ctx) override;
+  std::any visitArray(std::shared_ptr<expressions::ArrayLiteralAst> ctx) override;
+  std::any visitRange(std::shared_ptr<expressions::RangeAst> ctx) override;
+  std::any visitDomainExpr(std::shared_ptr<expressions::DomainExprAst> ctx) override;
+};
+} // namespace gazprea::ast::walkers
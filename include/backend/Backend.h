@@ -9,6 +9,7 @@
 #include "mlir/Conversion/SCFToControlFlow/SCFToControlFlow.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Transforms/Passes.h"
 
 // Translation
 #include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
@@ -16,6 +17,10 @@
 #include "mlir/Target/LLVMIR/Export.h"
 #include "llvm/Support/raw_os_ostream.h"
 
+// LLVM optimization and code generation
+#include "llvm/Passes/OptimizationLevel.h"
+#include "llvm/Target/TargetMachine.h"
+
 // MLIR IR
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinAttributes.h"
@@ -38,12 +43,15 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "symTable/ArrayTypeSymbol.h"
+#include "symTable/MethodSymbol.h"
 #include <symTable/VariableSymbol.h>
 #include <symTable/VectorTypeSymbol.h>
 
+#include <optional>
+#include <unordered_set>
+
 namespace gazprea::backend {
 constexpr char kStreamStateGlobalName[] = "stream_state_019ae35e_4e0e_7d02_98f8_6e5abd8135e9";
-constexpr char kScanfName[] = "scanf_019ae392_2fe0_72fc_ad1e_94bb9c5662c0";
 constexpr char kPrintfName[] = "printf_019ae38d_3df3_74a3_b276_d9a9f7a8008b";
 constexpr char kIpowName[] = "ipow_019addc8_6352_7de5_8629_b0688522175f";
 constexpr char kThrowDivByZeroErrorName[] =
@@ -52,19 +60,46 @@ constexpr char kThrowArraySizeErrorName[] =
     "throwArraySizeError_019addc8_cc3a_71c7_b15f_8745c510199c";
 constexpr char kThrowVectorSizeErrorName[] =
     "throwVectorSizeError_019addc9_1a57_7674_b3dd_79d0624d2029";
+constexpr char kPrintIntName[] = "printInt_01d858cd_0ba2_4a81_b0a9_06d7e3d9abad";
+constexpr char kPrintRealName[] = "printReal_c83e6797_64d7_4731_99f3_4518febb9f33";
+constexpr char kPrintCharName[] = "printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1";
+constexpr char kFlushOutputName[] = "flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6";
+constexpr char kReadIntName[] = "readInt_5b0f6d0e_2a4c_4f61_9f0b_8c7d3e1a4b52";
+constexpr char kReadRealName[] = "readReal_0e7c94a1_63d2_4b8f_a5e0_2f9b71c4d836";
+constexpr char kReadCharName[] = "readChar_c3a8e5f2_7d14_4b9e_8a61_05f4b2d9c7e3";
+constexpr char kReadBoolName[] = "readBool_9d2f4a67_e1b8_4c35_b7a0_6e83c5f1d294";
 constexpr char kPrintArrayName[] = "printArray_019addab_1674_72d4_aa4a_ac782e511e7a";
 constexpr char kThrowStrideErrorName[] = "throwStrideError_a2beb751_ff3b_4d60_aefb_60f92ff9f4be";
 constexpr char kMallocName[] = "malloc_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c123";
 constexpr char kFreeName[] = "free_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c124";
 constexpr char kSnprintfName[] = "snprintf_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c125";
+constexpr char kMatrixAllocName[] = "matrixAlloc_4a6352fd_482b_41d7_bffb_ea6343a0ad4a";
+constexpr char kVectorPushNName[] = "vectorPushN_f45b275b_f953_4dea_9434_7caa2cfde681";
+constexpr char kDotIntName[] = "dotInt_43278ed6_4b97_4ad9_bc49_faca19ec0531";
+constexpr char kDotRealName[] = "dotReal_b9019883_c117_44a4_8c27_0c79ef55eb46";
+constexpr char kRowDotsIntName[] = "rowDotsInt_288495c2_dba5_44e3_b4ef_4edf7e561cec";
+constexpr char kRowDotsRealName[] = "rowDotsReal_1c2193d2_e9bb_4961_8748_2958826a6b5a";
+constexpr char kMemoLookupName[] = "memoLookup_7c1e4b92_d35a_4f08_9b6e_2a84f0c5d713";
+constexpr char kMemoStoreName[] = "memoStore_e5a09d37_18c4_4b6f_a2d1_93f7b0e64c28";
+constexpr char kBufferShareName[] = "bufferShare_943de2b6_a4f4_4b0b_b5b3_a56a3a070d8d";
+constexpr char kBufferUnshareName[] = "bufferUnshare_1cbee388_d48b_4526_bc31_ca1b14bd0d34";
+constexpr char kBufferViewName[] = "bufferView_5d0c8e3a_62f1_4e7b_9a45_c3b8f17d2e90";
 enum class VectorOffset { Size = 0, Capacity = 1, Data = 2, Is2D = 3 };
 class Backend final : public ast::walkers::AstWalker {
 public:
-  explicit Backend(const std::shared_ptr<ast::Ast> &ast);
+  explicit Backend(const std::shared_ptr<ast::Ast> &ast, unsigned optLevel = 0);
 
   int emitModule();
   int lowerDialects();
   void dumpLLVM(std::ostream &os);
+  int emitObject(const std::string &path);
+  int linkExecutable(const std::string &objectPath, const std::string &exePath,
+                     const std::string &runtimeDir) const;
+  int runJIT(const std::string &runtimeDir, int &exitCode);
+  unsigned getOptLevel() const { return optLevel; }
+  void setPassReport(bool enabled) { passReport = enabled; }
+  void setRuntimeKernels(bool enabled) { runtimeKernels = enabled; }
+  void setMemoizeFunctions(bool enabled) { memoizeFunctions = enabled; }
   std::any visitRoot(std::shared_ptr<ast::RootAst> ctx) override;
   std::any visitAssignment(std::shared_ptr<ast::statements::AssignmentAst> ctx) override;
   std::any visitDeclaration(std::shared_ptr<ast::statements::DeclarationAst> ctx) override;
@@ -143,8 +178,13 @@ public:
                            mlir::Value rightArrayStruct);
   mlir::Value concatVectors(std::shared_ptr<symTable::Type> type, mlir::Value leftVectorStruct,
                             mlir::Value rightVectorStruct);
+  mlir::LLVM::LLVMFuncOp getOrCreateVectorPushNFunc();
+  mlir::Value pushVectorSlots(mlir::Value vectorStruct, mlir::Type elementMLIRType,
+                              mlir::Value count);
   void throwIfVectorSizeNotEqual(mlir::Value left, mlir::Value right,
                                  std::shared_ptr<symTable::Type> type);
+  void throwIfStrideNotPositive(mlir::Value step);
+  mlir::Value getStridedCount(mlir::Value size, mlir::Value step);
   mlir::Value strideArrayByScalar(std::shared_ptr<symTable::Type> type, mlir::Value arrayStruct,
                                   mlir::Value scalarValue);
   mlir::Value strideVectorByScalar(std::shared_ptr<symTable::Type> type, mlir::Value vectorStruct,
@@ -167,10 +207,11 @@ public:
 
 protected:
   void setupPrintf() const;
-  void setupScanf() const;
+  void setupReadScalars() const;
   void setupIntPow() const;
   void setupPrintArray() const;
   void setupPrintString() const;
+  void setupPrintScalars() const;
   void setupThrowDivisionByZeroError() const;
   void setupThrowArraySizeError() const;
   void setupThrowVectorSizeError() const;
@@ -183,7 +224,6 @@ protected:
   void makeLengthBuiltin();
   void makeShapeBuiltin();
   void makeReverseBuiltin();
-  void printChar(char c);
   void printArray(mlir::Value arrayStructAddr, std::shared_ptr<symTable::Type> arrayType);
   mlir::Value applyUnaryToScalar(ast::expressions::UnaryOpType op,
                                  std::shared_ptr<symTable::Type> type, mlir::OpBuilder &b,
@@ -216,7 +256,63 @@ protected:
   mlir::Value maxSubVectorSize(mlir::Value vectorStruct,
                                std::shared_ptr<symTable::Type> vectorType);
   mlir::Value mallocArray(mlir::Type elementMLIRType, mlir::Value elementCount);
+  mlir::LLVM::LLVMFuncOp getOrCreateMatrixAllocFunc();
+  mlir::Value mallocMatrix(mlir::Type elementMLIRType, mlir::Value rows, mlir::Value cols);
+  mlir::Value getMatrixElements(mlir::OpBuilder &b, mlir::Location l, mlir::Value matrixData,
+                                mlir::Value rows);
+  mlir::LLVM::LLVMFuncOp getOrCreateDotFunc(bool isReal);
+  mlir::LLVM::LLVMFuncOp getOrCreateRowDotsFunc(bool isReal);
+  mlir::LLVM::LLVMFuncOp getOrCreateMemoLookupFunc();
+  mlir::LLVM::LLVMFuncOp getOrCreateMemoStoreFunc();
+  bool isMemoizable(mlir::LLVM::LLVMFuncOp funcOp,
+                    std::shared_ptr<symTable::MethodSymbol> methodSym,
+                    const std::vector<std::shared_ptr<ast::Ast>> &params) const;
+  void emitMemoizedWrapper(mlir::LLVM::LLVMFuncOp funcOp,
+                           std::shared_ptr<symTable::MethodSymbol> methodSym,
+                           const std::vector<std::shared_ptr<ast::Ast>> &params);
+  // Small function inlining: calls to a function whose body is a single `return expr;` over scalars
+  // are generated in place with the params bound straight to the argument values
+  std::shared_ptr<ast::statements::ReturnAst>
+  getInlinableReturn(const std::shared_ptr<symTable::MethodSymbol> &methodSym) const;
+  bool emitInlinedCall(std::shared_ptr<ast::expressions::FuncProcCallAst> ctx,
+                       const std::shared_ptr<symTable::MethodSymbol> &methodSym);
+  // Self tail calls become loops for functions and procedures taking only const scalars
+  void beginTailCallLoop(const std::shared_ptr<ast::prototypes::PrototypeAst> &proto,
+                         const std::shared_ptr<ast::statements::StatementAst> &body);
+  bool emitSelfTailCall(const std::shared_ptr<ast::Ast> &site,
+                        const std::vector<std::shared_ptr<ast::expressions::ArgAst>> &args);
+  mlir::Value emitDotKernel(std::shared_ptr<symTable::Type> opType,
+                            std::shared_ptr<symTable::Type> leftType,
+                            std::shared_ptr<symTable::Type> rightType, mlir::Value leftAddr,
+                            mlir::Value rightAddr);
+  // Lazy ranges: a loop or generator over `a..b` counts from start instead of building the array
+  std::shared_ptr<ast::expressions::RangeAst>
+  getRangeDomain(const std::shared_ptr<ast::expressions::DomainExprAst> &domainExpr) const;
+  std::pair<mlir::Value, mlir::Value>
+  emitRangeBounds(const std::shared_ptr<ast::expressions::RangeAst> &range);
+  // Lazy strides: a loop or generator over `a by k` steps through the buffer of `a` instead of
+  // building the strided array. `addr` is the temporary operand or snapshot to free after the
+  // loop; it is null when the loop reads a variable's own storage.
+  struct StrideDomain {
+    std::shared_ptr<symTable::Type> type;
+    mlir::Value addr, dataPtr, step, count;
+  };
+  std::shared_ptr<ast::expressions::BinaryAst>
+  getStrideDomain(const std::shared_ptr<ast::expressions::DomainExprAst> &domainExpr) const;
+  StrideDomain emitStrideDomain(const std::shared_ptr<ast::expressions::BinaryAst> &stride,
+                                bool snapshot);
+  void emitGeneratorDomain(const std::shared_ptr<ast::expressions::DomainExprAst> &domainExpr,
+                           mlir::Value &size, mlir::Value &dataPtr, mlir::Value &rangeStart,
+                           StrideDomain &stride);
+  mlir::Value generatorDomainElement(mlir::OpBuilder &b, mlir::Location l, mlir::Value dataPtr,
+                                     mlir::Value rangeStart, mlir::Value step, mlir::Value idx);
   mlir::Value getTypeSizeInBytes(mlir::Type elementType);
+  mlir::Value getByteCount(mlir::OpBuilder &b, mlir::Location l, mlir::Type elementType,
+                           mlir::Value count);
+  void copyElements(mlir::OpBuilder &b, mlir::Location l, mlir::Value destPtr, mlir::Value srcPtr,
+                    mlir::Type elementType, mlir::Value count);
+  void fillElements(mlir::OpBuilder &b, mlir::Location l, mlir::Value dataPtr,
+                    mlir::Type elementType, mlir::Value value, mlir::Value count);
   mlir::Value getDefaultValue(std::shared_ptr<symTable::Type> type);
   void padArrayWithValue(mlir::Value arrayStruct, std::shared_ptr<symTable::Type> arrayType,
                          mlir::Value currentSize, mlir::Value targetSize, mlir::Value defaultValue);
@@ -226,6 +322,16 @@ protected:
                         mlir::Value targetOuterSize, mlir::Value targetInnerSize);
   void copyArrayStruct(std::shared_ptr<symTable::Type> type, mlir::Value fromArrayStruct,
                        mlir::Value destArrayStruct);
+  // Copy-on-write: 1D arrays and vectors of scalars can share one data buffer, whose owners are
+  // counted by the runtime. Writers call makeBufferUnique first and frees drop one owner.
+  bool isSharableType(const std::shared_ptr<symTable::Type> &type) const;
+  mlir::LLVM::LLVMFuncOp getOrCreateBufferShareFunc();
+  mlir::LLVM::LLVMFuncOp getOrCreateBufferUnshareFunc();
+  mlir::LLVM::LLVMFuncOp getOrCreateBufferViewFunc();
+  std::pair<mlir::Value, mlir::Value> getBufferExtent(std::shared_ptr<symTable::Type> type,
+                                                      mlir::Value containerAddr);
+  void shareValue(std::shared_ptr<symTable::Type> type, mlir::Value fromAddr, mlir::Value destAddr);
+  void makeBufferUnique(std::shared_ptr<symTable::Type> type, mlir::Value containerAddr);
   bool isTypeTuple(const std::shared_ptr<symTable::Type> &value);
   bool isTypeStruct(const std::shared_ptr<symTable::Type> &value);
   void freeCompositeType(const std::vector<std::shared_ptr<symTable::Type>> &resolvedTypes,
@@ -243,6 +349,9 @@ protected:
   std::pair<mlir::Value, std::shared_ptr<symTable::ArrayTypeSymbol>>
   convertVectorToArrayStruct(mlir::Value vectorStruct,
                              std::shared_ptr<symTable::VectorTypeSymbol> vectorType);
+  std::pair<mlir::Value, std::shared_ptr<symTable::ArrayTypeSymbol>>
+  viewVectorAsArrayStruct(mlir::Value vectorStruct,
+                          std::shared_ptr<symTable::VectorTypeSymbol> vectorType);
   mlir::Value normalizeIndex(mlir::Value index, mlir::Value arraySize);
   void copyArrayElementsToSlice(mlir::Value srcArrayStruct,
                                 std::shared_ptr<symTable::Type> srcArrayType,
@@ -254,6 +363,16 @@ protected:
   mlir::Value castIfNeeded(std::shared_ptr<ast::Ast> ctx, mlir::Value valueAddr,
                            std::shared_ptr<symTable::Type> fromType,
                            std::shared_ptr<symTable::Type> toType);
+  // Moves an aggregate temporary instead of deep-copying it: takes `valueAddr` off the free list of
+  // the scope that owns it and returns true, or returns false when `expr` does not allocate its
+  // result
+  bool releaseTemporary(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                        std::shared_ptr<symTable::Type> type, mlir::Value valueAddr);
+  // True when a const param of this type can read the argument in place: casting would leave the
+  // value untouched and there are no declared sizes to check or pad to
+  bool canPassByReference(const std::shared_ptr<ast::types::DataTypeAst> &paramTypeAst,
+                          std::shared_ptr<symTable::Type> argType,
+                          std::shared_ptr<symTable::Type> paramType);
   mlir::Value castScalarToArray(std::shared_ptr<ast::Ast> ctx, mlir::Value scalarValue,
                                 std::shared_ptr<symTable::Type> scalarType,
                                 std::shared_ptr<symTable::Type> arrayType);
@@ -305,8 +424,21 @@ protected:
 
 private:
   std::shared_ptr<ast::Ast> ast;
+  // 0-3, mirrors the -O flag given to gazc
+  unsigned optLevel;
+  // Print per-pass op counts and timings while lowering
+  bool passReport = false;
+  // Use the libgazrt kernels for `**` instead of inline loops
+  bool runtimeKernels = true;
+  // Cache results of self-recursive functions over scalars in a runtime hash table
+  bool memoizeFunctions = false;
   std::unordered_map<std::string, mlir::Value> blockArg;
   std::shared_ptr<ast::prototypes::PrototypeAst> currentFunctionProto;
+  // Functions whose calls are being inlined right now, so recursion falls back to a real call
+  std::vector<const symTable::MethodSymbol *> inlineStack;
+  // Set while evaluating a var argument: element accesses in it are written through by the callee,
+  // so the collection they point into must own its buffer
+  bool evaluatingVarArg = false;
 
   struct LoopContext {
     mlir::Block *exitBlock = nullptr;
@@ -314,6 +446,17 @@ private:
   };
   std::vector<LoopContext> loopStack;
 
+  // Self tail calls of the function being emitted store their arguments into the param slots and
+  // jump back to the header instead of calling
+  struct TailCallLoop {
+    std::unordered_set<const ast::Ast *> sites;
+    std::vector<std::shared_ptr<ast::Ast>> params;
+    std::vector<mlir::Value> paramSlots;
+    mlir::Block *headerBlock = nullptr;
+    mlir::Value stackPtr;
+  };
+  std::optional<TailCallLoop> tailCallLoop;
+
   // MLIR
   mlir::MLIRContext context;
   mlir::ModuleOp module;
@@ -323,6 +466,17 @@ private:
   // LLVM
   llvm::LLVMContext llvm_context;
   std::unique_ptr<llvm::Module> llvm_module;
+  std::unique_ptr<llvm::TargetMachine> targetMachine;
+
+  void hoistAllocasToEntry();
+  void addMLIROptimizationPasses(mlir::PassManager &pm) const;
+  void addLLVMDialectCleanupPasses(mlir::PassManager &pm) const;
+  void addPassReport(mlir::PassManager &pm) const;
+  int translateToLLVM();
+  std::unique_ptr<llvm::Module> translateToLLVM(llvm::LLVMContext &targetContext);
+  std::unique_ptr<llvm::TargetMachine> createHostTargetMachine() const;
+  llvm::OptimizationLevel getLLVMOptLevel() const;
+  void optimizeLLVM(llvm::Module &llvmModule);
 
   mlir::Value constOne() const;
   mlir::Value constZero() const;
@@ -356,6 +510,57 @@ private:
                                         std::shared_ptr<symTable::Type> leftType,
                                         std::shared_ptr<symTable::Type> rightType,
                                         mlir::Value leftAddr, mlir::Value rightAddr);
+  mlir::Value scalarBinaryValue(ast::expressions::BinaryOpType op, bool isReal,
+                                mlir::Value leftValue, mlir::Value rightValue);
+  mlir::Value powerOperandToValue(std::shared_ptr<ast::Ast> ctx,
+                                  std::shared_ptr<symTable::Type> opType,
+                                  std::shared_ptr<symTable::Type> leftType,
+                                  std::shared_ptr<symTable::Type> rightType, mlir::Value leftAddr,
+                                  mlir::Value rightAddr);
+  mlir::Value emitPower(bool isReal, mlir::Value base, mlir::Value exponent);
+  mlir::Value emitConstantIntPower(mlir::Value base, int64_t exponent);
+  std::optional<int64_t> getIntConstant(mlir::Value value);
+  bool isElementwiseBinaryOp(ast::expressions::BinaryOpType op) const;
+  std::shared_ptr<symTable::Type>
+  elementwiseElementType(const std::shared_ptr<symTable::Type> &type);
+  mlir::Value getContainerSizeAddr(const std::shared_ptr<symTable::Type> &type, mlir::Value addr);
+  mlir::Value getContainerDataAddr(const std::shared_ptr<symTable::Type> &type, mlir::Value addr);
+  mlir::Value createContainerStruct(const std::shared_ptr<symTable::Type> &type,
+                                    mlir::Value dataPtr, mlir::Value size);
+  mlir::Value emitElementwiseBinary(ast::expressions::BinaryOpType op,
+                                    std::shared_ptr<symTable::Type> opType,
+                                    std::shared_ptr<symTable::Type> leftType,
+                                    std::shared_ptr<symTable::Type> rightType, mlir::Value leftAddr,
+                                    mlir::Value rightAddr);
+  bool elementwiseOperandsCompatible(ast::expressions::BinaryOpType op,
+                                     const std::shared_ptr<symTable::Type> &resultElementType,
+                                     const std::shared_ptr<symTable::Type> &leftElementType,
+                                     const std::shared_ptr<symTable::Type> &rightElementType,
+                                     bool &isReal);
+
+  // Element-wise expression fusion: a tree of element-wise ops over 1D scalar containers is lowered
+  // to a single loop. Leaves are the subexpressions that are evaluated normally beforehand.
+  struct FusedLeaf {
+    std::shared_ptr<symTable::Type> type;
+    std::shared_ptr<symTable::Type> elementType;
+    bool isScalar;
+    // loaded scalar value, or the container's data pointer
+    mlir::Value valueOrData;
+    mlir::Value size;
+  };
+  using FusedLeafMap = std::unordered_map<const ast::Ast *, FusedLeaf>;
+  bool tryEmitFusedExpression(const std::shared_ptr<ast::expressions::ExpressionAst> &root);
+  bool isFusableExpression(const std::shared_ptr<ast::expressions::ExpressionAst> &expr);
+  std::vector<std::shared_ptr<ast::expressions::ExpressionAst>>
+  getFusedChildren(const std::shared_ptr<ast::expressions::ExpressionAst> &expr);
+  size_t countFusedNodes(const std::shared_ptr<ast::expressions::ExpressionAst> &expr);
+  void collectFusedLeaves(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                          std::vector<std::shared_ptr<ast::expressions::ExpressionAst>> &leaves);
+  std::shared_ptr<symTable::Type>
+  getFusedElementType(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                      const FusedLeafMap &leaves);
+  mlir::Value emitFusedElement(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                               const FusedLeafMap &leaves, mlir::Value index);
   static bool typesEquivalent(const std::shared_ptr<symTable::Type> &lhs,
                               const std::shared_ptr<symTable::Type> &rhs);
   mlir::Value promoteScalarValue(mlir::Value value, const std::shared_ptr<symTable::Type> &fromType,
@@ -373,6 +578,7 @@ private:
   void readReal(mlir::Value destAddr);
   void readCharacter(mlir::Value destAddr);
   void readBoolean(mlir::Value destAddr);
+  void readScalar(const char *readFuncName, mlir::Value destAddr);
 
   void handleSingularIndexAccess(std::shared_ptr<ast::expressions::ArrayAccessAst> ctx,
                                  std::shared_ptr<symTable::Type> instanceType, mlir::Value size,
@@ -381,7 +587,7 @@ private:
   void handleRangedIndexAccess(std::shared_ptr<ast::expressions::ArrayAccessAst> ctx,
                                std::shared_ptr<symTable::Type> instanceType,
                                mlir::Value instanceAddr, mlir::Value size, mlir::Value dataPtr,
-                               mlir::Type structType);
+                               mlir::Type structType, bool isWrittenThrough);
   enum class CastPolicy { AllowReallocate, InPlaceOnly };
   //
   // bool isArrayTypeName(const std::shared_ptr<symTable::Type> &t) const;
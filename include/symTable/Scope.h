@@ -1,6 +1,7 @@
 #pragma once
 #include "Symbol.h"
 
+#include <algorithm>
 #include <memory>
 #include <mlir/IR/Value.h>
 #include <string>
@@ -41,6 +42,12 @@ public:
     return elementsToFree;
   }
   void clearElementsToFree() { elementsToFree.clear(); }
+  // Forget `val` when its buffers now belong to something else
+  void removeElementToFree(mlir::Value val) {
+    elementsToFree.erase(std::remove_if(elementsToFree.begin(), elementsToFree.end(),
+                                        [&](const auto &element) { return element.second == val; }),
+                         elementsToFree.end());
+  }
   void popElementFromScopeStack() { scopeStack.pop_back(); }
   std::pair<std::shared_ptr<Type>, mlir::Value> getTopElementInStack() { return scopeStack.back(); }
   std::pair<std::shared_ptr<Type>, mlir::Value> getSecondElementInStack() {
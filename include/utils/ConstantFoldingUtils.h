@@ -0,0 +1,56 @@
+#pragma once
+#include "ast/expressions/BinaryAst.h"
+#include "ast/expressions/UnaryAst.h"
+#include "symTable/SymTable.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace gazprea::utils {
+
+enum class ConstantKind { Integer, Real, Character, Boolean };
+
+// Value of a scalar known at compile time. Only the field matching `kind` is meaningful.
+struct ConstantValue {
+  ConstantKind kind;
+  int32_t intValue = 0;
+  float realValue = 0.0f;
+  char charValue = 0;
+  bool boolValue = false;
+};
+
+// Name of the built-in type holding a value of this kind ("integer", "real", ...)
+std::string constantKindName(ConstantKind kind);
+bool isScalarTypeName(const std::string &typeName);
+
+ConstantValue makeIntConstant(int32_t value);
+ConstantValue makeRealConstant(float value);
+ConstantValue makeCharConstant(char value);
+ConstantValue makeBoolConstant(bool value);
+// Value a scalar declaration without an initializer starts with
+std::optional<ConstantValue> zeroConstant(const std::string &typeName);
+
+// Value of a literal node, or nullopt for anything else
+std::optional<ConstantValue>
+literalValue(const std::shared_ptr<ast::expressions::ExpressionAst> &expr);
+
+// The fold* helpers compute exactly what the code emitted by the backend computes. They return
+// nullopt whenever the operation has to be left to runtime, e.g. because it raises an error there.
+std::optional<ConstantValue> foldBinary(ast::expressions::BinaryOpType op,
+                                        const ConstantValue &left, const ConstantValue &right);
+std::optional<ConstantValue> foldUnary(ast::expressions::UnaryOpType op,
+                                       const ConstantValue &operand);
+std::optional<ConstantValue> foldCast(const ConstantValue &value, const std::string &targetName);
+
+// Literal node for `value`, located at and scoped like `replaced` and typed the way
+// ValidationWalker types literals
+std::shared_ptr<ast::expressions::ExpressionAst>
+makeLiteral(const std::shared_ptr<symTable::SymbolTable> &symTab, const ConstantValue &value,
+            const std::shared_ptr<ast::expressions::ExpressionAst> &replaced);
+
+// True when validation inferred exactly the type of `value` for `expr`
+bool matchesInferredType(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                         const ConstantValue &value);
+
+} // namespace gazprea::utils
@@ -4,8 +4,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+// Writes out buffered program output, so it lands before the error message
+void flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6(void);
+
 #define DEF_RUN_TIME_ERROR(NAME)                      \
 void NAME(const char *description) {                  \
+    flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6(); \
     fprintf(stderr, "%s: %s \n", #NAME, description); \
     exit(1);                                          \
 }
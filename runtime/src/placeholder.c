@@ -1,36 +1,347 @@
 #include "run_time_errors.h"
+#include <ctype.h>
+#include <errno.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
+// Square-and-multiply in unsigned arithmetic, which wraps exactly like the repeated product
 int32_t ipow_019addc8_6352_7de5_8629_b0688522175f(int32_t base, int32_t exp) {
-  int32_t result = 1;
-  for (int32_t i = 0; i < exp; i++) {
-    result *= base;
+  uint32_t result = 1;
+  uint32_t square = (uint32_t)base;
+  while (exp > 0) {
+    if (exp & 1) {
+      result *= square;
+    }
+    square *= square;
+    exp >>= 1;
   }
-  return result;
+  return (int32_t)result;
+}
+
+// Program output is collected in one buffer instead of a locked stdio call per printed value. It is
+// written out when full, before input is read, before a runtime error is reported and at exit.
+#define OUTPUT_BUFFER_SIZE 65536
+
+static char outputBuffer[OUTPUT_BUFFER_SIZE];
+static size_t outputLength;
+static int outputFlushRegistered;
+
+void flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6(void) {
+  if (outputLength > 0) {
+    fwrite(outputBuffer, 1, outputLength, stdout);
+    outputLength = 0;
+  }
+  fflush(stdout);
+}
+
+// Makes room for `count` more bytes in the buffer
+static void outputReserve(size_t count) {
+  if (!outputFlushRegistered) {
+    atexit(flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6);
+    outputFlushRegistered = 1;
+  }
+  if (outputLength + count > OUTPUT_BUFFER_SIZE) {
+    flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6();
+  }
+}
+
+static void outputBytes(const char *bytes, size_t count) {
+  if (count >= OUTPUT_BUFFER_SIZE) {
+    flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6();
+    fwrite(bytes, 1, count, stdout);
+    return;
+  }
+  outputReserve(count);
+  memcpy(outputBuffer + outputLength, bytes, count);
+  outputLength += count;
+}
+
+void printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1(char c) {
+  outputReserve(1);
+  outputBuffer[outputLength++] = c;
+}
+
+void printInt_01d858cd_0ba2_4a81_b0a9_06d7e3d9abad(int32_t value) {
+  char digits[11];
+  int count = 0;
+  // Negate in unsigned so INT32_MIN does not overflow
+  uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+  do {
+    digits[count++] = (char)('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  outputReserve((size_t)count + 1);
+  if (value < 0) {
+    outputBuffer[outputLength++] = '-';
+  }
+  while (count > 0) {
+    outputBuffer[outputLength++] = digits[--count];
+  }
+}
+
+void printReal_c83e6797_64d7_4731_99f3_4518febb9f33(float value) {
+  char text[32];
+  int count = snprintf(text, sizeof(text), "%g", (double)value);
+  outputBytes(text, (size_t)count);
 }
 
 int printf_019ae38d_3df3_74a3_b276_d9a9f7a8008b(const char *format, ...) {
+  char text[256];
   va_list args;
   va_start(args, format);
-  int result = vprintf(format, args);
+  int result = vsnprintf(text, sizeof(text), format, args);
   va_end(args);
-  return result;
-}
-
-int scanf_019ae392_2fe0_72fc_ad1e_94bb9c5662c0(const char *format, ...) {
-  va_list args;
+  if (result < 0) {
+    return result;
+  }
+  if ((size_t)result < sizeof(text)) {
+    outputBytes(text, (size_t)result);
+    return result;
+  }
+  char *longText = malloc((size_t)result + 1);
   va_start(args, format);
-  int result = vscanf(format, args);
+  vsnprintf(longText, (size_t)result + 1, format, args);
   va_end(args);
+  outputBytes(longText, (size_t)result);
+  free(longText);
   return result;
 }
 
+// Input is read from stdin in large chunks and parsed in place. Each reader consumes exactly the
+// characters the matching scanf conversion ("%512d", "%512f", "%c", " %1[TF]") would and returns
+// the resulting stream_state.
+#define INPUT_BUFFER_SIZE 65536
+#define INPUT_WIDTH 512
+#define STREAM_OK 0
+#define STREAM_ERROR 1
+#define STREAM_EOF 2
+
+static char inputBuffer[INPUT_BUFFER_SIZE];
+static size_t inputPosition;
+static size_t inputLength;
+static int inputExhausted;
+
+// Returns the next input character without consuming it, or EOF
+static int inputPeek(void) {
+  if (inputPosition == inputLength) {
+    if (inputExhausted) {
+      return EOF;
+    }
+    // Whatever the program printed so far (e.g. a prompt) must be visible before blocking
+    flushOutput_48806719_5e3a_45df_8039_9104dec3e9c6();
+    ssize_t count;
+    do {
+      count = read(STDIN_FILENO, inputBuffer, INPUT_BUFFER_SIZE);
+    } while (count < 0 && errno == EINTR);
+    if (count <= 0) {
+      inputExhausted = 1;
+      return EOF;
+    }
+    inputPosition = 0;
+    inputLength = (size_t)count;
+  }
+  return (unsigned char)inputBuffer[inputPosition];
+}
+
+// Skips leading whitespace, returns the first other character or EOF
+static int inputSkipSpace(void) {
+  int c;
+  while ((c = inputPeek()) != EOF && isspace(c)) {
+    inputPosition++;
+  }
+  return c;
+}
+
+int32_t readInt_5b0f6d0e_2a4c_4f61_9f0b_8c7d3e1a4b52(int32_t *dest) {
+  *dest = 0;
+  if (inputSkipSpace() == EOF) {
+    return STREAM_EOF;
+  }
+  char token[INPUT_WIDTH + 1];
+  int length = 0;
+  int digits = 0;
+  int c = inputPeek();
+  if (c == '-' || c == '+') {
+    token[length++] = (char)c;
+    inputPosition++;
+  }
+  while (length < INPUT_WIDTH && (c = inputPeek()) != EOF && isdigit(c)) {
+    token[length++] = (char)c;
+    inputPosition++;
+    digits++;
+  }
+  if (!digits) {
+    return STREAM_ERROR;
+  }
+  token[length] = '\0';
+  // Same wrap-around as scanf's long-to-int narrowing
+  *dest = (int32_t)strtol(token, NULL, 10);
+  return STREAM_OK;
+}
+
+// Consumes the next character if it matches `expected` case-insensitively. A mismatching
+// character is consumed as well, like scanf does while matching "inf" and "nan".
+static int inputMatchLower(char *token, int *length, int *width, char expected) {
+  int c = inputPeek();
+  if (*width == 0 || c == EOF) {
+    return 0;
+  }
+  inputPosition++;
+  (*width)--;
+  if (tolower(c) != expected) {
+    return 0;
+  }
+  token[(*length)++] = (char)c;
+  return 1;
+}
+
+int32_t readReal_0e7c94a1_63d2_4b8f_a5e0_2f9b71c4d836(float *dest) {
+  *dest = 0.0f;
+  if (inputSkipSpace() == EOF) {
+    return STREAM_EOF;
+  }
+  char token[INPUT_WIDTH + 2];
+  int length = 0;
+  int width = INPUT_WIDTH;
+  int gotSign = 0;
+  int gotDigit = 0;
+  int gotDot = 0;
+  int gotExponent = 0;
+  int hex = 0;
+  char exponentChar = 'e';
+  int c = inputPeek();
+
+  if (c == '-' || c == '+') {
+    token[length++] = (char)c;
+    inputPosition++;
+    width--;
+    gotSign = 1;
+    if ((c = inputPeek()) == EOF) {
+      return STREAM_ERROR;
+    }
+  }
+
+  if (tolower(c) == 'n') {
+    token[length++] = (char)c;
+    inputPosition++;
+    width--;
+    if (!inputMatchLower(token, &length, &width, 'a') ||
+        !inputMatchLower(token, &length, &width, 'n')) {
+      return STREAM_ERROR;
+    }
+  } else if (tolower(c) == 'i') {
+    token[length++] = (char)c;
+    inputPosition++;
+    width--;
+    if (!inputMatchLower(token, &length, &width, 'n') ||
+        !inputMatchLower(token, &length, &width, 'f')) {
+      return STREAM_ERROR;
+    }
+    // Once "infi" is seen the whole of "infinity" is required
+    if (width != 0 && tolower(inputPeek()) == 'i') {
+      const char *rest = "inity";
+      while (*rest) {
+        if (!inputMatchLower(token, &length, &width, *rest++)) {
+          return STREAM_ERROR;
+        }
+      }
+    }
+  } else {
+    if (c == '0') {
+      token[length++] = '0';
+      inputPosition++;
+      width--;
+      c = inputPeek();
+      if (width != 0 && tolower(c) == 'x') {
+        token[length++] = (char)c;
+        inputPosition++;
+        width--;
+        hex = 1;
+        exponentChar = 'p';
+      } else {
+        gotDigit = 1;
+      }
+    }
+    while (width != 0 && (c = inputPeek()) != EOF) {
+      if (isdigit(c) || (hex && !gotExponent && isxdigit(c))) {
+        gotDigit = 1;
+      } else if (gotExponent && tolower(token[length - 1]) == exponentChar &&
+                 (c == '-' || c == '+')) {
+        // Sign of the exponent
+      } else if (gotDigit && !gotExponent && tolower(c) == exponentChar) {
+        gotExponent = gotDot = 1;
+      } else if (!gotDot && c == '.') {
+        gotDot = 1;
+      } else {
+        break;
+      }
+      token[length++] = (char)c;
+      inputPosition++;
+      width--;
+    }
+    if (length == gotSign + (hex ? 2 : 0)) {
+      return STREAM_ERROR;
+    }
+  }
+
+  token[length] = '\0';
+  char *end;
+  float value = strtof(token, &end);
+  if (end == token) {
+    return STREAM_ERROR;
+  }
+  *dest = value;
+  return STREAM_OK;
+}
+
+int32_t readChar_c3a8e5f2_7d14_4b9e_8a61_05f4b2d9c7e3(char *dest) {
+  int c = inputPeek();
+  if (c == EOF) {
+    *dest = -1;
+    return STREAM_EOF;
+  }
+  inputPosition++;
+  *dest = (char)c;
+  return STREAM_OK;
+}
+
+int32_t readBool_9d2f4a67_e1b8_4c35_b7a0_6e83c5f1d294(bool *dest) {
+  *dest = false;
+  int c = inputSkipSpace();
+  if (c == EOF) {
+    return STREAM_EOF;
+  }
+  if (c != 'T' && c != 'F') {
+    return STREAM_ERROR;
+  }
+  inputPosition++;
+  *dest = c == 'T';
+  return STREAM_OK;
+}
+
 void *malloc_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c123(size_t size) { return malloc(size); }
 
-void free_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c124(void *ptr) { free(ptr); }
+static int isMatrixRow(void *ptr);
+static void releaseMatrixRows(void *ptr);
+static int dropSharedOwner(void *ptr);
+
+void free_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c124(void *ptr) {
+  // A buffer shared by copy-on-write copies is released by its last owner
+  if (dropSharedOwner(ptr)) {
+    return;
+  }
+  // Rows of a dense matrix are owned by the matrix block and released with it
+  if (isMatrixRow(ptr)) {
+    return;
+  }
+  releaseMatrixRows(ptr);
+  free(ptr);
+}
 
 int snprintf_019b1cf2_3c2e_4f9f_a8d1_b2c5e7f0c125(char *str, size_t size, const char *format, ...) {
   va_list args;
@@ -63,23 +374,370 @@ typedef struct {
   int8_t is2D; // boolean
 } ArrayStruct;
 
-void printString_d526a5bb_a01a_4579_9d33_c725c674e1c5(ArrayStruct *vectorStruct) {
-  int8_t *charData = (int8_t *)vectorStruct->data;
-  for (int32_t i = 0; i < vectorStruct->size; i++) {
-    if (charData[i] == '\0') {
-      break; // Stop at null terminator for strings
+// Dense matrices: the row headers and a row-major element buffer share one allocation. The row
+// data pointers point into that buffer, so they are recorded here and free() on them is a no-op.
+typedef struct {
+  void *key;
+  int32_t rows; // -1 for a row entry
+  int64_t rowBytes;
+} MatrixEntry;
+
+#define MATRIX_EMPTY ((void *)0)
+#define MATRIX_TOMBSTONE ((void *)1)
+
+static MatrixEntry *matrixTable;
+static size_t matrixCapacity;
+static size_t matrixUsed; // live entries plus tombstones
+static size_t matrixLive;
+
+static size_t matrixHash(void *ptr) {
+  uintptr_t x = (uintptr_t)ptr;
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  return (size_t)x;
+}
+
+static MatrixEntry *matrixFind(void *ptr) {
+  if (matrixLive == 0 || ptr == MATRIX_EMPTY) {
+    return NULL;
+  }
+  size_t mask = matrixCapacity - 1;
+  for (size_t i = matrixHash(ptr) & mask;; i = (i + 1) & mask) {
+    if (matrixTable[i].key == ptr) {
+      return &matrixTable[i];
+    }
+    if (matrixTable[i].key == MATRIX_EMPTY) {
+      return NULL;
+    }
+  }
+}
+
+static void matrixInsert(void *ptr, int32_t rows, int64_t rowBytes);
+
+static void matrixGrow(void) {
+  MatrixEntry *old = matrixTable;
+  size_t oldCapacity = matrixCapacity;
+  matrixCapacity = oldCapacity ? oldCapacity * 2 : 256;
+  matrixTable = calloc(matrixCapacity, sizeof(MatrixEntry));
+  matrixUsed = 0;
+  matrixLive = 0;
+  for (size_t i = 0; i < oldCapacity; i++) {
+    if (old[i].key != MATRIX_EMPTY && old[i].key != MATRIX_TOMBSTONE) {
+      matrixInsert(old[i].key, old[i].rows, old[i].rowBytes);
     }
-    printf("%c", charData[i]);
   }
+  free(old);
+}
+
+static void matrixInsert(void *ptr, int32_t rows, int64_t rowBytes) {
+  if ((matrixUsed + 1) * 2 > matrixCapacity) {
+    matrixGrow();
+  }
+  size_t mask = matrixCapacity - 1;
+  size_t i = matrixHash(ptr) & mask;
+  while (matrixTable[i].key != MATRIX_EMPTY && matrixTable[i].key != MATRIX_TOMBSTONE) {
+    i = (i + 1) & mask;
+  }
+  if (matrixTable[i].key == MATRIX_EMPTY) {
+    matrixUsed++;
+  }
+  matrixTable[i].key = ptr;
+  matrixTable[i].rows = rows;
+  matrixTable[i].rowBytes = rowBytes;
+  matrixLive++;
+}
+
+static void matrixErase(MatrixEntry *entry) {
+  entry->key = MATRIX_TOMBSTONE;
+  matrixLive--;
+}
+
+static int isMatrixRow(void *ptr) {
+  MatrixEntry *entry = matrixFind(ptr);
+  return entry && entry->rows < 0;
+}
+
+static void releaseMatrixRows(void *ptr) {
+  MatrixEntry *block = matrixFind(ptr);
+  if (!block || block->rows < 0) {
+    return;
+  }
+  int32_t rows = block->rows;
+  int64_t rowBytes = block->rowBytes;
+  matrixErase(block);
+  // Headers may have been reassigned since, so recompute the original row pointers
+  char *elements = (char *)ptr + (size_t)rows * sizeof(ArrayStruct);
+  for (int32_t i = 0; i < rows; i++) {
+    MatrixEntry *row = matrixFind(elements + (size_t)i * rowBytes);
+    if (row) {
+      matrixErase(row);
+    }
+  }
+}
+
+// Returns the data block of a rows x cols matrix: `rows` row headers followed by the elements in
+// row-major order. Rows of zero width get a null data pointer.
+void *matrixAlloc_4a6352fd_482b_41d7_bffb_ea6343a0ad4a(int32_t rows, int32_t cols,
+                                                        int64_t elementSize) {
+  if (rows < 0) {
+    rows = 0;
+  }
+  if (cols < 0) {
+    cols = 0;
+  }
+  int64_t rowBytes = (int64_t)cols * elementSize;
+  size_t headerBytes = (size_t)rows * sizeof(ArrayStruct);
+  ArrayStruct *headers = malloc(headerBytes + (size_t)rows * (size_t)rowBytes);
+  char *elements = (char *)headers + headerBytes;
+  for (int32_t i = 0; i < rows; i++) {
+    headers[i].size = cols;
+    headers[i].data = rowBytes ? elements + (size_t)i * rowBytes : NULL;
+    headers[i].is2D = 0;
+  }
+  if (rows && rowBytes) {
+    matrixInsert(headers, rows, rowBytes);
+    for (int32_t i = 0; i < rows; i++) {
+      matrixInsert(headers[i].data, -1, 0);
+    }
+  }
+  return headers;
+}
+
+// Copy-on-write buffers: copies of a 1D array or vector share its data buffer, and the table
+// counts the owners of every buffer that is shared. A buffer not in the table has a single owner.
+// Slices are views: their data points into another buffer, and the view entry keeps that buffer
+// alive with one owner of its own until the last holder of the view releases it.
+typedef struct {
+  void *key;
+  int32_t owners;
+  void *base; // the buffer a view points into, or NULL for a buffer of its own
+} ShareEntry;
+
+static ShareEntry *shareTable;
+static size_t shareCapacity;
+static size_t shareUsed; // live entries plus tombstones
+static size_t shareLive;
+
+static ShareEntry *shareFind(void *ptr) {
+  if (shareLive == 0 || ptr == MATRIX_EMPTY) {
+    return NULL;
+  }
+  size_t mask = shareCapacity - 1;
+  for (size_t i = matrixHash(ptr) & mask;; i = (i + 1) & mask) {
+    if (shareTable[i].key == ptr) {
+      return &shareTable[i];
+    }
+    if (shareTable[i].key == MATRIX_EMPTY) {
+      return NULL;
+    }
+  }
+}
+
+static void shareInsert(void *ptr, int32_t owners, void *base);
+
+static void shareGrow(void) {
+  ShareEntry *old = shareTable;
+  size_t oldCapacity = shareCapacity;
+  // Reads of const arrays share and release buffers all the time, so when most of the table is
+  // tombstones it is rebuilt at the same size instead of growing
+  shareCapacity = oldCapacity;
+  if (oldCapacity == 0) {
+    shareCapacity = 256;
+  } else if (shareLive * 4 > oldCapacity) {
+    shareCapacity = oldCapacity * 2;
+  }
+  shareTable = calloc(shareCapacity, sizeof(ShareEntry));
+  shareUsed = 0;
+  shareLive = 0;
+  for (size_t i = 0; i < oldCapacity; i++) {
+    if (old[i].key != MATRIX_EMPTY && old[i].key != MATRIX_TOMBSTONE) {
+      shareInsert(old[i].key, old[i].owners, old[i].base);
+    }
+  }
+  free(old);
+}
+
+static void shareInsert(void *ptr, int32_t owners, void *base) {
+  if ((shareUsed + 1) * 2 > shareCapacity) {
+    shareGrow();
+  }
+  size_t mask = shareCapacity - 1;
+  size_t i = matrixHash(ptr) & mask;
+  while (shareTable[i].key != MATRIX_EMPTY && shareTable[i].key != MATRIX_TOMBSTONE) {
+    i = (i + 1) & mask;
+  }
+  if (shareTable[i].key == MATRIX_EMPTY) {
+    shareUsed++;
+  }
+  shareTable[i].key = ptr;
+  shareTable[i].owners = owners;
+  shareTable[i].base = base;
+  shareLive++;
+}
+
+// Gives up one owner's claim on a shared buffer or a view. Returns 0 when the buffer was not
+// shared, in which case the caller is its only owner.
+static int dropSharedOwner(void *ptr) {
+  ShareEntry *entry = shareFind(ptr);
+  if (!entry) {
+    return 0;
+  }
+  if (entry->base) {
+    if (--entry->owners == 0) {
+      void *base = entry->base;
+      entry->key = MATRIX_TOMBSTONE;
+      shareLive--;
+      if (!dropSharedOwner(base)) {
+        free(base);
+      }
+    }
+    return 1;
+  }
+  if (--entry->owners == 1) {
+    entry->key = MATRIX_TOMBSTONE;
+    shareLive--;
+  }
+  return 1;
+}
+
+// Returns a private copy of `data` for a writer if the buffer is shared or a view, or `data`
+// itself. The copy is taken before the claim is dropped, since that may free a view's base.
+static void *unshareBuffer(void *data, size_t allocBytes, size_t copyBytes) {
+  if (!shareFind(data)) {
+    return data;
+  }
+  void *copy = malloc(allocBytes ? allocBytes : 1);
+  if (copyBytes) {
+    memcpy(copy, data, copyBytes);
+  }
+  dropSharedOwner(data);
+  return copy;
+}
+
+// Adds an owner to the `bytes` long buffer `data` and returns it. Matrix storage cannot be shared
+// since its rows are released with the block, so those are copied instead.
+void *bufferShare_943de2b6_a4f4_4b0b_b5b3_a56a3a070d8d(void *data, int64_t bytes) {
+  if (!data) {
+    return data;
+  }
+  if (matrixFind(data)) {
+    void *copy = malloc(bytes > 0 ? (size_t)bytes : 1);
+    if (bytes > 0) {
+      memcpy(copy, data, (size_t)bytes);
+    }
+    return copy;
+  }
+  ShareEntry *entry = shareFind(data);
+  if (entry) {
+    entry->owners++;
+  } else {
+    shareInsert(data, 2, NULL);
+  }
+  return data;
+}
+
+// Returns a view of the `bytes` long slice at `start` inside the data buffer `data`, which gains
+// an owner for as long as the view is held. Writers unshare the view like any shared buffer.
+void *bufferView_5d0c8e3a_62f1_4e7b_9a45_c3b8f17d2e90(void *data, void *start, int64_t bytes) {
+  if (bytes <= 0 || matrixFind(data)) {
+    void *copy = malloc(bytes > 0 ? (size_t)bytes : 1);
+    if (bytes > 0) {
+      memcpy(copy, start, (size_t)bytes);
+    }
+    return copy;
+  }
+  // A slice of a view points into the view's own base
+  ShareEntry *entry = shareFind(data);
+  void *base = entry && entry->base ? entry->base : data;
+  if (start == base) {
+    return bufferShare_943de2b6_a4f4_4b0b_b5b3_a56a3a070d8d(base, bytes);
+  }
+  entry = shareFind(start);
+  if (entry) {
+    entry->owners++;
+    return start;
+  }
+  bufferShare_943de2b6_a4f4_4b0b_b5b3_a56a3a070d8d(base, bytes);
+  shareInsert(start, 1, base);
+  return start;
+}
+
+// Called before writing to the `bytes` long buffer `data`: returns a private copy if it is shared
+void *bufferUnshare_1cbee388_d48b_4526_bc31_ca1b14bd0d34(void *data, int64_t bytes) {
+  size_t size = bytes > 0 ? (size_t)bytes : 0;
+  return unshareBuffer(data, size, size);
+}
+
+typedef struct {
+  int32_t size;
+  int32_t capacity;
+  void *data;
+  int8_t is2D; // boolean
+} VectorStruct;
+
+// Makes room for at least `count` elements. Capacity grows geometrically so a run of pushes costs
+// amortized O(1) each, and realloc can often extend the buffer in place.
+void vectorReserve_aad89bd1_4b2d_4999_bec0_1b33618f53ba(VectorStruct *vector, int32_t count,
+                                                         int64_t elementSize) {
+  // Growing writes past the size, so even spare capacity must not be shared
+  vector->data =
+      unshareBuffer(vector->data, (size_t)vector->capacity * (size_t)elementSize,
+                    (size_t)(vector->size > 0 ? vector->size : 0) * (size_t)elementSize);
+  if (count <= vector->capacity) {
+    return;
+  }
+  int64_t capacity = (int64_t)vector->capacity * 2;
+  if (capacity < 4) {
+    capacity = 4;
+  }
+  if (capacity < count) {
+    capacity = count;
+  }
+  if (capacity > INT32_MAX) {
+    capacity = INT32_MAX;
+  }
+  size_t bytes = (size_t)capacity * (size_t)elementSize;
+  if (matrixFind(vector->data)) {
+    // Dense matrix storage cannot be moved because row pointers point into it
+    void *data = malloc(bytes);
+    if (vector->size > 0) {
+      memcpy(data, vector->data, (size_t)vector->size * (size_t)elementSize);
+    }
+    vector->data = data;
+  } else {
+    vector->data = realloc(vector->data, bytes);
+  }
+  vector->capacity = (int32_t)capacity;
+}
+
+// Grows the vector by `count` elements and returns the address of the first new slot
+void *vectorPushN_f45b275b_f953_4dea_9434_7caa2cfde681(VectorStruct *vector, int32_t count,
+                                                        int64_t elementSize) {
+  int32_t size = vector->size;
+  vectorReserve_aad89bd1_4b2d_4999_bec0_1b33618f53ba(vector, size + count, elementSize);
+  vector->size = size + count;
+  return (char *)vector->data + (size_t)size * (size_t)elementSize;
+}
+
+void printString_d526a5bb_a01a_4579_9d33_c725c674e1c5(ArrayStruct *vectorStruct) {
+  const char *charData = (const char *)vectorStruct->data;
+  size_t length = vectorStruct->size > 0 ? (size_t)vectorStruct->size : 0;
+  // Stop at null terminator for strings
+  const char *terminator = length ? memchr(charData, '\0', length) : NULL;
+  if (terminator) {
+    length = (size_t)(terminator - charData);
+  }
+  outputBytes(charData, length);
 }
 
 void printArray_019addab_1674_72d4_aa4a_ac782e511e7a(ArrayStruct *arrayStruct,
                                                      int32_t elementType) {
-  printf("[");
+  printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1('[');
 
   for (int32_t i = 0; i < arrayStruct->size; i++) {
     if (i > 0) {
-      printf(" ");
+      printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1(' ');
     }
 
     if (arrayStruct->is2D) {
@@ -89,27 +747,168 @@ void printArray_019addab_1674_72d4_aa4a_ac782e511e7a(ArrayStruct *arrayStruct,
       switch (elementType) {
       case ELEM_INT: {
         int32_t *intData = (int32_t *)arrayStruct->data;
-        printf("%d", intData[i]);
+        printInt_01d858cd_0ba2_4a81_b0a9_06d7e3d9abad(intData[i]);
         break;
       }
       case ELEM_REAL: {
         float *floatData = (float *)arrayStruct->data;
-        printf("%g", (double)floatData[i]);
+        printReal_c83e6797_64d7_4731_99f3_4518febb9f33(floatData[i]);
         break;
       }
       case ELEM_CHAR: {
-        int8_t *charData = (int8_t *)arrayStruct->data;
-        printf("%c", charData[i]);
+        char *charData = (char *)arrayStruct->data;
+        printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1(charData[i]);
         break;
       }
       case ELEM_BOOL: {
         int8_t *boolData = (int8_t *)arrayStruct->data;
-        printf("%c", boolData[i] ? 'T' : 'F');
+        printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1(boolData[i] ? 'T' : 'F');
         break;
       }
       }
     }
   }
 
-  printf("]");
+  printChar_e2b2aadf_080b_4207_b6c0_e7121e1eb0c1(']');
+}
+
+// Dot product kernels for `**`. Independent accumulators break the dependency chain of the add so
+// the compiler can keep several lanes in flight; integer sums wrap like the generated code does.
+int32_t dotInt_43278ed6_4b97_4ad9_bc49_faca19ec0531(const int32_t *left, const int32_t *right,
+                                                    int32_t size) {
+  uint32_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+  int32_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    acc0 += (uint32_t)left[i] * (uint32_t)right[i];
+    acc1 += (uint32_t)left[i + 1] * (uint32_t)right[i + 1];
+    acc2 += (uint32_t)left[i + 2] * (uint32_t)right[i + 2];
+    acc3 += (uint32_t)left[i + 3] * (uint32_t)right[i + 3];
+  }
+  for (; i < size; ++i) {
+    acc0 += (uint32_t)left[i] * (uint32_t)right[i];
+  }
+  return (int32_t)(acc0 + acc1 + acc2 + acc3);
+}
+
+float dotReal_b9019883_c117_44a4_8c27_0c79ef55eb46(const float *left, const float *right,
+                                                   int32_t size) {
+  float acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+  int32_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    acc0 += left[i] * right[i];
+    acc1 += left[i + 1] * right[i + 1];
+    acc2 += left[i + 2] * right[i + 2];
+    acc3 += left[i + 3] * right[i + 3];
+  }
+  for (; i < size; ++i) {
+    acc0 += left[i] * right[i];
+  }
+  return (acc0 + acc1) + (acc2 + acc3);
+}
+
+// `**` on 2D arrays is the dot product of each pair of rows, with the same row size check as the
+// 1D operator.
+#define DEF_ROW_DOTS(NAME, TYPE, DOT)                                                            \
+  void NAME(const ArrayStruct *left, const ArrayStruct *right, TYPE *result, int32_t rows) {    \
+    const ArrayStruct *leftRows = (const ArrayStruct *)left->data;                              \
+    const ArrayStruct *rightRows = (const ArrayStruct *)right->data;                            \
+    for (int32_t i = 0; i < rows; ++i) {                                                        \
+      if (leftRows[i].size != rightRows[i].size) {                                              \
+        throwArraySizeError_019addc8_cc3a_71c7_b15f_8745c510199c();                             \
+      }                                                                                         \
+      result[i] = DOT((const TYPE *)leftRows[i].data, (const TYPE *)rightRows[i].data,          \
+                      rightRows[i].size);                                                       \
+    }                                                                                           \
+  }
+
+DEF_ROW_DOTS(rowDotsInt_288495c2_dba5_44e3_b4ef_4edf7e561cec, int32_t,
+             dotInt_43278ed6_4b97_4ad9_bc49_faca19ec0531)
+DEF_ROW_DOTS(rowDotsReal_1c2193d2_e9bb_4961_8748_2958826a6b5a, float,
+             dotReal_b9019883_c117_44a4_8c27_0c79ef55eb46)
+
+// Result caches for memoized functions. Each function owns one table pointer (null until the first
+// store); keys are the call's arguments widened to 64 bits, values the widened result.
+typedef struct {
+  int32_t keyLength;
+  size_t capacity; // power of two
+  size_t count;
+  int64_t *keys; // capacity * keyLength
+  int64_t *values;
+  bool *used;
+} MemoTable;
+
+static size_t memoHash(const int64_t *key, int32_t keyLength) {
+  uint64_t h = 0x9e3779b97f4a7c15ULL;
+  for (int32_t i = 0; i < keyLength; i++) {
+    h ^= (uint64_t)key[i];
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+  }
+  return (size_t)h;
+}
+
+// Slot holding `key`, or the empty slot where it would be inserted
+static size_t memoSlot(const MemoTable *table, const int64_t *key) {
+  size_t mask = table->capacity - 1;
+  size_t bytes = (size_t)table->keyLength * sizeof(int64_t);
+  for (size_t i = memoHash(key, table->keyLength) & mask;; i = (i + 1) & mask) {
+    if (!table->used[i] || memcmp(table->keys + i * table->keyLength, key, bytes) == 0) {
+      return i;
+    }
+  }
+}
+
+static void memoResize(MemoTable *table, size_t capacity) {
+  MemoTable old = *table;
+  table->capacity = capacity;
+  table->keys = malloc(capacity * (size_t)table->keyLength * sizeof(int64_t) + 1);
+  table->values = malloc(capacity * sizeof(int64_t));
+  table->used = calloc(capacity, sizeof(bool));
+  for (size_t i = 0; i < old.capacity; i++) {
+    if (old.used[i]) {
+      size_t slot = memoSlot(table, old.keys + i * old.keyLength);
+      memcpy(table->keys + slot * table->keyLength, old.keys + i * old.keyLength,
+             (size_t)old.keyLength * sizeof(int64_t));
+      table->values[slot] = old.values[i];
+      table->used[slot] = true;
+    }
+  }
+  free(old.keys);
+  free(old.values);
+  free(old.used);
+}
+
+bool memoLookup_7c1e4b92_d35a_4f08_9b6e_2a84f0c5d713(void **tablePtr, const int64_t *key,
+                                                    int64_t *result) {
+  MemoTable *table = *tablePtr;
+  if (!table) {
+    return false;
+  }
+  size_t slot = memoSlot(table, key);
+  if (!table->used[slot]) {
+    return false;
+  }
+  *result = table->values[slot];
+  return true;
+}
+
+void memoStore_e5a09d37_18c4_4b6f_a2d1_93f7b0e64c28(void **tablePtr, const int64_t *key,
+                                                   int32_t keyLength, int64_t result) {
+  MemoTable *table = *tablePtr;
+  if (!table) {
+    table = calloc(1, sizeof(MemoTable));
+    table->keyLength = keyLength;
+    memoResize(table, 64);
+    *tablePtr = table;
+  }
+  if ((table->count + 1) * 2 > table->capacity) {
+    memoResize(table, table->capacity * 2);
+  }
+  size_t slot = memoSlot(table, key);
+  if (!table->used[slot]) {
+    memcpy(table->keys + slot * table->keyLength, key, (size_t)keyLength * sizeof(int64_t));
+    table->used[slot] = true;
+    table->count++;
+  }
+  table->values[slot] = result;
 }
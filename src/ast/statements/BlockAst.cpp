@@ -14,4 +14,7 @@ std::string BlockAst::toStringTree(std::string prefix) const {
 }
 std::vector<std::shared_ptr<Ast>> BlockAst::getChildren() const { return children; }
 void BlockAst::addChildren(std::shared_ptr<Ast> child) { children.push_back(child); }
+void BlockAst::setChildren(const std::vector<std::shared_ptr<Ast>> &children_) {
+  children = children_;
+}
 } // namespace gazprea::ast::statements
\ No newline at end of file
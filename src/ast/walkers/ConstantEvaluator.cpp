@@ -0,0 +1,238 @@
+#include "symTable/MethodSymbol.h"
+#include "symTable/VariableSymbol.h"
+#include <ast/walkers/ConstantEvaluator.h>
+
+namespace gazprea::ast::walkers {
+
+namespace {
+// Thrown as soon as the call cannot be evaluated at compile time; caught by evaluateCall
+struct EvaluationAborted {};
+
+std::string typeName(const std::shared_ptr<symTable::Symbol> &symbol) {
+  const auto variableSymbol = std::dynamic_pointer_cast<symTable::VariableSymbol>(symbol);
+  if (!variableSymbol || !variableSymbol->getType())
+    throw EvaluationAborted{};
+  return variableSymbol->getType()->getName();
+}
+
+utils::ConstantValue convert(const std::optional<utils::ConstantValue> &value,
+                             const std::string &targetName) {
+  if (!value || !utils::isScalarTypeName(targetName))
+    throw EvaluationAborted{};
+  const auto converted = utils::foldCast(*value, targetName);
+  if (!converted)
+    throw EvaluationAborted{};
+  return *converted;
+}
+
+utils::ConstantValue checked(const std::shared_ptr<expressions::ExpressionAst> &ctx,
+                             const std::optional<utils::ConstantValue> &value) {
+  if (!value || !utils::matchesInferredType(ctx, *value))
+    throw EvaluationAborted{};
+  return *value;
+}
+} // namespace
+
+std::optional<utils::ConstantValue>
+ConstantEvaluator::evaluateCall(const std::shared_ptr<symTable::Symbol> &callee,
+                                const std::vector<utils::ConstantValue> &args) {
+  frames.clear();
+  returnValue.reset();
+  fuel = kEvaluationFuel;
+  try {
+    return call(callee, args);
+  } catch (const EvaluationAborted &) {
+    return std::nullopt;
+  }
+}
+
+void ConstantEvaluator::consumeFuel() {
+  if (fuel == 0)
+    throw EvaluationAborted{};
+  --fuel;
+}
+
+utils::ConstantValue
+ConstantEvaluator::evaluate(const std::shared_ptr<expressions::ExpressionAst> &expr) {
+  if (!expr)
+    throw EvaluationAborted{};
+  auto result = visit(expr);
+  if (const auto *value = std::any_cast<utils::ConstantValue>(&result))
+    return *value;
+  throw EvaluationAborted{};
+}
+
+ConstantEvaluator::Flow ConstantEvaluator::execute(const std::shared_ptr<Ast> &statement) {
+  consumeFuel();
+  auto result = visit(statement);
+  if (const auto *flow = std::any_cast<Flow>(&result))
+    return *flow;
+  // Any statement without a visitor here (I/O, procedure calls, aggregates) is not evaluated
+  throw EvaluationAborted{};
+}
+
+bool ConstantEvaluator::evaluateCondition(
+    const std::shared_ptr<expressions::ExpressionAst> &condition) {
+  const auto value = evaluate(condition);
+  if (value.kind != utils::ConstantKind::Boolean)
+    throw EvaluationAborted{};
+  return value.boolValue;
+}
+
+utils::ConstantValue ConstantEvaluator::call(const std::shared_ptr<symTable::Symbol> &callee,
+                                             const std::vector<utils::ConstantValue> &args) {
+  const auto methodSymbol = std::dynamic_pointer_cast<symTable::MethodSymbol>(callee);
+  if (!methodSymbol || methodSymbol->getScopeType() != symTable::ScopeType::Function ||
+      !methodSymbol->getReturnType())
+    throw EvaluationAborted{};
+  const auto function = std::dynamic_pointer_cast<prototypes::FunctionAst>(methodSymbol->getDef());
+  if (!function || !function->getBody() || frames.size() >= kMaxCallDepth)
+    throw EvaluationAborted{};
+
+  const auto &params = function->getProto()->getParams();
+  if (params.size() != args.size())
+    throw EvaluationAborted{};
+  Frame frame;
+  for (size_t i = 0; i < params.size(); ++i)
+    frame[params[i]->getSymbol().get()] = convert(args[i], typeName(params[i]->getSymbol()));
+
+  frames.push_back(std::move(frame));
+  returnValue.reset();
+  const Flow flow = execute(function->getBody());
+  frames.pop_back();
+  if (flow != Flow::Return)
+    throw EvaluationAborted{};
+
+  auto result = convert(returnValue, methodSymbol->getReturnType()->getName());
+  returnValue.reset();
+  return result;
+}
+
+std::any ConstantEvaluator::visitBlock(std::shared_ptr<statements::BlockAst> ctx) {
+  for (const auto &child : ctx->getChildren()) {
+    const Flow flow = execute(child);
+    if (flow != Flow::Normal)
+      return flow;
+  }
+  return Flow::Normal;
+}
+
+std::any ConstantEvaluator::visitDeclaration(std::shared_ptr<statements::DeclarationAst> ctx) {
+  const auto targetName = typeName(ctx->getSymbol());
+  const auto value =
+      ctx->getExpr() ? std::optional(evaluate(ctx->getExpr())) : utils::zeroConstant(targetName);
+  frames.back()[ctx->getSymbol().get()] = convert(value, targetName);
+  return Flow::Normal;
+}
+
+std::any ConstantEvaluator::visitAssignment(std::shared_ptr<statements::AssignmentAst> ctx) {
+  const auto lVal = std::dynamic_pointer_cast<statements::IdentifierLeftAst>(ctx->getLVal());
+  if (!lVal)
+    throw EvaluationAborted{};
+  const auto variable = frames.back().find(lVal->getSymbol().get());
+  if (variable == frames.back().end())
+    throw EvaluationAborted{};
+  variable->second = convert(evaluate(ctx->getExpr()), typeName(lVal->getSymbol()));
+  return Flow::Normal;
+}
+
+std::any ConstantEvaluator::visitReturn(std::shared_ptr<statements::ReturnAst> ctx) {
+  if (ctx->getExpr())
+    returnValue = evaluate(ctx->getExpr());
+  return Flow::Return;
+}
+
+std::any ConstantEvaluator::visitConditional(std::shared_ptr<statements::ConditionalAst> ctx) {
+  if (evaluateCondition(ctx->getCondition()))
+    return execute(ctx->getThenBody());
+  if (ctx->getElseBody())
+    return execute(ctx->getElseBody());
+  return Flow::Normal;
+}
+
+std::any ConstantEvaluator::visitLoop(std::shared_ptr<statements::LoopAst> ctx) {
+  const auto condition = ctx->getCondition();
+  const bool isPostPredicated = ctx->getIsPostPredicated();
+  while (true) {
+    consumeFuel();
+    if (condition && !isPostPredicated && !evaluateCondition(condition))
+      break;
+    const Flow flow = execute(ctx->getBody());
+    if (flow == Flow::Return)
+      return flow;
+    if (flow == Flow::Break)
+      break;
+    if (condition && isPostPredicated && !evaluateCondition(condition))
+      break;
+  }
+  return Flow::Normal;
+}
+
+std::any ConstantEvaluator::visitBreak(std::shared_ptr<statements::BreakAst> ctx) {
+  return Flow::Break;
+}
+
+std::any ConstantEvaluator::visitContinue(std::shared_ptr<statements::ContinueAst> ctx) {
+  return Flow::Continue;
+}
+
+std::any ConstantEvaluator::visitStructFuncCallRouter(
+    std::shared_ptr<expressions::StructFuncCallRouterAst> ctx) {
+  if (ctx->getIsStruct())
+    throw EvaluationAborted{};
+  return checked(ctx, evaluate(ctx->getFuncProcCallAst()));
+}
+
+std::any ConstantEvaluator::visitFuncProcCall(std::shared_ptr<expressions::FuncProcCallAst> ctx) {
+  std::vector<utils::ConstantValue> args;
+  for (const auto &arg : ctx->getArgs())
+    args.push_back(evaluate(arg->getExpr()));
+  return checked(ctx, call(ctx->getSymbol(), args));
+}
+
+std::any ConstantEvaluator::visitBinary(std::shared_ptr<expressions::BinaryAst> ctx) {
+  const auto left = evaluate(ctx->getLeft());
+  const auto right = evaluate(ctx->getRight());
+  return checked(ctx, utils::foldBinary(ctx->getBinaryOpType(), left, right));
+}
+
+std::any ConstantEvaluator::visitUnary(std::shared_ptr<expressions::UnaryAst> ctx) {
+  return checked(ctx, utils::foldUnary(ctx->getUnaryOpType(), evaluate(ctx->getExpression())));
+}
+
+std::any ConstantEvaluator::visitCast(std::shared_ptr<expressions::CastAst> ctx) {
+  const auto value = evaluate(ctx->getExpression());
+  if (!ctx->getResolvedTargetType())
+    throw EvaluationAborted{};
+  return checked(ctx, utils::foldCast(value, ctx->getResolvedTargetType()->getName()));
+}
+
+std::any ConstantEvaluator::visitIdentifier(std::shared_ptr<expressions::IdentifierAst> ctx) {
+  auto *symbol = ctx->getSymbol().get();
+  if (const auto local = frames.back().find(symbol); local != frames.back().end())
+    return local->second;
+  // Globals are const, so the only ones readable here are those folded to a literal
+  const auto global = constValues.find(symbol);
+  if (global == constValues.end() || !ctx->getInferredSymbolType())
+    throw EvaluationAborted{};
+  return checked(ctx, utils::foldCast(*utils::literalValue(global->second),
+                                      ctx->getInferredSymbolType()->getName()));
+}
+
+std::any ConstantEvaluator::visitInteger(std::shared_ptr<expressions::IntegerLiteralAst> ctx) {
+  return *utils::literalValue(ctx);
+}
+
+std::any ConstantEvaluator::visitReal(std::shared_ptr<expressions::RealLiteralAst> ctx) {
+  return *utils::literalValue(ctx);
+}
+
+std::any ConstantEvaluator::visitChar(std::shared_ptr<expressions::CharLiteralAst> ctx) {
+  return *utils::literalValue(ctx);
+}
+
+std::any ConstantEvaluator::visitBool(std::shared_ptr<expressions::BoolLiteralAst> ctx) {
+  return *utils::literalValue(ctx);
+}
+
+} // namespace gazprea::ast::walkers
@@ -0,0 +1,275 @@
+#include "symTable/MethodSymbol.h"
+#include <ast/walkers/ConstantEvaluator.h>
+#include <ast/walkers/ConstantFoldingWalker.h>
+
+namespace gazprea::ast::walkers {
+
+namespace {
+std::optional<bool> literalCondition(const std::shared_ptr<expressions::ExpressionAst> &condition) {
+  const auto value = utils::literalValue(condition);
+  if (!value || value->kind != utils::ConstantKind::Boolean)
+    return std::nullopt;
+  return value->boolValue;
+}
+
+// Records the variable behind every input statement. Input is allowed into a const, so its
+// initializer is not the value later statements read.
+void collectInputTargets(const std::shared_ptr<Ast> &node,
+                         std::unordered_set<symTable::Symbol *> &targets) {
+  if (!node)
+    return;
+  if (const auto input = std::dynamic_pointer_cast<statements::InputAst>(node)) {
+    if (input->getLVal() && input->getLVal()->getSymbol())
+      targets.insert(input->getLVal()->getSymbol().get());
+  } else if (const auto root = std::dynamic_pointer_cast<RootAst>(node)) {
+    for (const auto &child : root->children)
+      collectInputTargets(child, targets);
+  } else if (const auto procedure = std::dynamic_pointer_cast<prototypes::ProcedureAst>(node)) {
+    collectInputTargets(procedure->getBody(), targets);
+  } else if (const auto block = std::dynamic_pointer_cast<statements::BlockAst>(node)) {
+    for (const auto &child : block->getChildren())
+      collectInputTargets(child, targets);
+  } else if (const auto conditional = std::dynamic_pointer_cast<statements::ConditionalAst>(node)) {
+    collectInputTargets(conditional->getThenBody(), targets);
+    collectInputTargets(conditional->getElseBody(), targets);
+  } else if (const auto loop = std::dynamic_pointer_cast<statements::LoopAst>(node)) {
+    collectInputTargets(loop->getBody(), targets);
+  } else if (const auto iteratorLoop =
+                 std::dynamic_pointer_cast<statements::IteratorLoopAst>(node)) {
+    collectInputTargets(iteratorLoop->getBody(), targets);
+  }
+}
+} // namespace
+
+std::shared_ptr<expressions::ExpressionAst>
+ConstantFoldingWalker::fold(const std::shared_ptr<expressions::ExpressionAst> &expr) {
+  if (!expr)
+    return expr;
+  auto result = visit(expr);
+  if (const auto *replacement = std::any_cast<std::shared_ptr<expressions::ExpressionAst>>(&result);
+      replacement && *replacement)
+    return *replacement;
+  return expr;
+}
+
+void ConstantFoldingWalker::visitArgs(
+    const std::vector<std::shared_ptr<expressions::ArgAst>> &args) {
+  for (const auto &arg : args)
+    visit(arg);
+}
+
+std::any ConstantFoldingWalker::visitRoot(std::shared_ptr<RootAst> ctx) {
+  collectInputTargets(ctx, inputTargets);
+  for (const auto &child : ctx->children)
+    visit(child);
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitFunction(std::shared_ptr<prototypes::FunctionAst> ctx) {
+  if (ctx->getBody())
+    visit(ctx->getBody());
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitProcedure(std::shared_ptr<prototypes::ProcedureAst> ctx) {
+  if (ctx->getBody())
+    visit(ctx->getBody());
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitBlock(std::shared_ptr<statements::BlockAst> ctx) {
+  std::vector<std::shared_ptr<Ast>> children;
+  for (const auto &child : ctx->getChildren()) {
+    auto result = visit(child);
+    const auto *replacement = std::any_cast<std::shared_ptr<Ast>>(&result);
+    if (!replacement) {
+      children.push_back(child);
+    } else if (*replacement) {
+      children.push_back(*replacement);
+    }
+  }
+  ctx->setChildren(children);
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitDeclaration(std::shared_ptr<statements::DeclarationAst> ctx) {
+  if (!ctx->getExpr())
+    return {};
+  ctx->setExpr(fold(ctx->getExpr()));
+
+  if (ctx->getQualifier() != Qualifier::Const)
+    return {};
+  if (utils::literalValue(ctx->getExpr()) && ctx->getSymbol() &&
+      !inputTargets.count(ctx->getSymbol().get()))
+    constValues[ctx->getSymbol().get()] = ctx->getExpr();
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitAssignment(std::shared_ptr<statements::AssignmentAst> ctx) {
+  ctx->setExpr(fold(ctx->getExpr()));
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitOutput(std::shared_ptr<statements::OutputAst> ctx) {
+  ctx->setExpression(fold(ctx->getExpression()));
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitReturn(std::shared_ptr<statements::ReturnAst> ctx) {
+  ctx->setExpr(fold(ctx->getExpr()));
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitConditional(std::shared_ptr<statements::ConditionalAst> ctx) {
+  ctx->setCondition(fold(ctx->getCondition()));
+  visit(ctx->getThenBody());
+  if (ctx->getElseBody())
+    visit(ctx->getElseBody());
+
+  const auto condition = literalCondition(ctx->getCondition());
+  if (!condition)
+    return {};
+  // The taken branch keeps its own block (and scope); the other one is never emitted
+  if (*condition)
+    return std::shared_ptr<Ast>(ctx->getThenBody());
+  return std::shared_ptr<Ast>(ctx->getElseBody());
+}
+
+std::any ConstantFoldingWalker::visitLoop(std::shared_ptr<statements::LoopAst> ctx) {
+  if (ctx->getCondition())
+    ctx->setCondition(fold(ctx->getCondition()));
+  visit(ctx->getBody());
+
+  // A do-while body still runs once, so only a pre-predicated loop can be dropped
+  const auto condition = literalCondition(ctx->getCondition());
+  if (condition && !*condition && !ctx->getIsPostPredicated())
+    return std::shared_ptr<Ast>(nullptr);
+  return {};
+}
+
+std::any
+ConstantFoldingWalker::visitIteratorLoop(std::shared_ptr<statements::IteratorLoopAst> ctx) {
+  visit(ctx->getDomain());
+  visit(ctx->getBody());
+  return {};
+}
+
+std::any
+ConstantFoldingWalker::visitProcedureCall(std::shared_ptr<statements::ProcedureCallAst> ctx) {
+  visitArgs(ctx->getArgs());
+  return {};
+}
+
+std::shared_ptr<expressions::ExpressionAst>
+ConstantFoldingWalker::evaluateCall(const std::shared_ptr<expressions::FuncProcCallAst> &call,
+                                    const std::shared_ptr<expressions::ExpressionAst> &replaced) {
+  const auto methodSymbol = std::dynamic_pointer_cast<symTable::MethodSymbol>(call->getSymbol());
+  if (!methodSymbol || methodSymbol->getScopeType() != symTable::ScopeType::Function)
+    return nullptr;
+  std::vector<utils::ConstantValue> args;
+  for (const auto &arg : call->getArgs()) {
+    const auto value = utils::literalValue(arg->getExpr());
+    if (!value)
+      return nullptr;
+    args.push_back(*value);
+  }
+
+  ConstantEvaluator evaluator(constValues);
+  const auto result = evaluator.evaluateCall(methodSymbol, args);
+  if (!result || !utils::matchesInferredType(replaced, *result))
+    return nullptr;
+  return utils::makeLiteral(symTab, *result, replaced);
+}
+
+std::any
+ConstantFoldingWalker::visitFuncProcCall(std::shared_ptr<expressions::FuncProcCallAst> ctx) {
+  visitArgs(ctx->getArgs());
+  return evaluateCall(ctx, ctx);
+}
+
+std::any ConstantFoldingWalker::visitStructFuncCallRouter(
+    std::shared_ptr<expressions::StructFuncCallRouterAst> ctx) {
+  if (ctx->getIsStruct())
+    return {};
+  visitArgs(ctx->getFuncProcCallAst()->getArgs());
+  return evaluateCall(ctx->getFuncProcCallAst(), ctx);
+}
+
+std::any ConstantFoldingWalker::visitArg(std::shared_ptr<expressions::ArgAst> ctx) {
+  ctx->setExpr(fold(ctx->getExpr()));
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitBinary(std::shared_ptr<expressions::BinaryAst> ctx) {
+  ctx->setLeft(fold(ctx->getLeft()));
+  ctx->setRight(fold(ctx->getRight()));
+
+  const auto left = utils::literalValue(ctx->getLeft());
+  const auto right = utils::literalValue(ctx->getRight());
+  if (!left || !right)
+    return {};
+  const auto value = utils::foldBinary(ctx->getBinaryOpType(), *left, *right);
+  if (!value || !utils::matchesInferredType(ctx, *value))
+    return {};
+  return utils::makeLiteral(symTab, *value, ctx);
+}
+
+std::any ConstantFoldingWalker::visitUnary(std::shared_ptr<expressions::UnaryAst> ctx) {
+  ctx->setExpression(fold(ctx->getExpression()));
+
+  const auto operand = utils::literalValue(ctx->getExpression());
+  if (!operand)
+    return {};
+  const auto value = utils::foldUnary(ctx->getUnaryOpType(), *operand);
+  if (!value || !utils::matchesInferredType(ctx, *value))
+    return {};
+  return utils::makeLiteral(symTab, *value, ctx);
+}
+
+std::any ConstantFoldingWalker::visitCast(std::shared_ptr<expressions::CastAst> ctx) {
+  ctx->setExpression(fold(ctx->getExpression()));
+
+  const auto operand = utils::literalValue(ctx->getExpression());
+  const auto targetType = ctx->getResolvedTargetType();
+  if (!operand || !targetType)
+    return {};
+  const auto value = utils::foldCast(*operand, targetType->getName());
+  if (!value || !utils::matchesInferredType(ctx, *value))
+    return {};
+  return utils::makeLiteral(symTab, *value, ctx);
+}
+
+std::any ConstantFoldingWalker::visitIdentifier(std::shared_ptr<expressions::IdentifierAst> ctx) {
+  const auto entry = constValues.find(ctx->getSymbol().get());
+  if (entry == constValues.end())
+    return {};
+  const auto inferredType = ctx->getInferredSymbolType();
+  if (!inferredType)
+    return {};
+  // The declaration may have promoted its initializer (const real x = 1;)
+  const auto value = utils::foldCast(*utils::literalValue(entry->second), inferredType->getName());
+  if (!value || !utils::matchesInferredType(ctx, *value))
+    return {};
+  return utils::makeLiteral(symTab, *value, ctx);
+}
+
+std::any ConstantFoldingWalker::visitArray(std::shared_ptr<expressions::ArrayLiteralAst> ctx) {
+  std::vector<std::shared_ptr<expressions::ExpressionAst>> elements;
+  for (const auto &element : ctx->getElements())
+    elements.push_back(fold(element));
+  ctx->setElements(elements);
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitRange(std::shared_ptr<expressions::RangeAst> ctx) {
+  ctx->setStart(fold(ctx->getStart()));
+  ctx->setEnd(fold(ctx->getEnd()));
+  return {};
+}
+
+std::any ConstantFoldingWalker::visitDomainExpr(std::shared_ptr<expressions::DomainExprAst> ctx) {
+  ctx->setDomainExpression(fold(ctx->getDomainExpression()));
+  return {};
+}
+
+} // namespace gazprea::ast::walkers
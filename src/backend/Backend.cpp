@@ -10,11 +10,17 @@
 #include "ast/expressions/CharLiteralAst.h"
 #include "ast/expressions/IntegerLiteralAst.h"
 #include "ast/types/ArrayTypeAst.h"
+#include "ast/types/StructTypeAst.h"
+#include "ast/types/TupleTypeAst.h"
+#include "ast/types/VectorTypeAst.h"
+
+#include "mlir/IR/Matchers.h"
 
 #include <backend/Backend.h>
+#include <map>
 namespace gazprea::backend {
-Backend::Backend(const std::shared_ptr<ast::Ast> &ast)
-    : ast(ast), loc(mlir::UnknownLoc::get(&context)) {
+Backend::Backend(const std::shared_ptr<ast::Ast> &ast, unsigned optLevel)
+    : ast(ast), optLevel(optLevel), loc(mlir::UnknownLoc::get(&context)) {
   // Load Dialects.
   context.loadDialect<mlir::LLVM::LLVMDialect>();
   context.loadDialect<mlir::func::FuncDialect>();
@@ -30,7 +36,7 @@ Backend::Backend(const std::shared_ptr<ast::Ast> &ast)
 
   // Some initial setup to get off the ground
   setupPrintf();
-  setupScanf();
+  setupReadScalars();
   setupIntPow();
   setupThrowDivisionByZeroError();
   setupThrowArraySizeError();
@@ -39,19 +45,17 @@ Backend::Backend(const std::shared_ptr<ast::Ast> &ast)
   setupThrowStrideError();
   setupPrintArray();
   setupPrintString();
+  setupPrintScalars();
   createGlobalString("%c\0", "charFormat");
-  createGlobalString("%c", "charInputFormat");
   createGlobalString("%d\0", "intFormat");
-  createGlobalString("%512d", "intInputFormat");
   createGlobalString("%g\0", "floatFormat");
-  createGlobalString("%512f", "floatInputFormat");
-  createGlobalString(" %1[TF]", "boolInputFormat");
   createGlobalStreamState();
 }
 
 int Backend::emitModule() {
 
   visit(ast);
+  hoistAllocasToEntry();
 
   // module.dump();
 
@@ -62,9 +66,56 @@ int Backend::emitModule() {
   return 0;
 }
 
+void Backend::hoistAllocasToEntry() {
+  // Codegen helpers create their temporaries wherever the builder currently is, which is often
+  // inside an scf.for body or a loop block. Such allocas grow the stack on every iteration, so move
+  // every fixed-size one into the entry block; each alloca site then becomes one stack slot that
+  // every iteration reuses.
+  module.walk([&](mlir::LLVM::LLVMFuncOp func) {
+    if (func.isExternal()) {
+      return;
+    }
+    mlir::Block &entry = func.getBody().front();
+
+    llvm::SmallVector<std::pair<mlir::LLVM::AllocaOp, int64_t>> slots;
+    func.walk([&](mlir::LLVM::AllocaOp alloca) {
+      mlir::IntegerAttr count;
+      if (mlir::matchPattern(alloca.getArraySize(), mlir::m_Constant(&count))) {
+        slots.emplace_back(alloca, count.getInt());
+      }
+    });
+    if (slots.empty()) {
+      return;
+    }
+
+    mlir::OpBuilder::InsertionGuard guard(*builder);
+    builder->setInsertionPointToStart(&entry);
+    std::map<int64_t, mlir::Value> counts;
+    mlir::Operation *lastSlot = nullptr;
+    for (auto &[alloca, count] : slots) {
+      if (!counts.count(count)) {
+        counts[count] = builder->create<mlir::LLVM::ConstantOp>(
+            alloca.getLoc(), alloca.getArraySize().getType(), count);
+        lastSlot = counts[count].getDefiningOp();
+      }
+    }
+    for (auto &[alloca, count] : slots) {
+      alloca->moveAfter(lastSlot);
+      alloca.getArraySizeMutable().assign(counts[count]);
+      lastSlot = alloca;
+    }
+  });
+}
+
 int Backend::lowerDialects() {
   // Set up the MLIR pass manager to iteratively lower all the Ops
   mlir::PassManager pm(&context);
+  if (passReport) {
+    addPassReport(pm);
+  }
+
+  // Clean up the emitted func/scf/arith mix while loop structure is still visible
+  addMLIROptimizationPasses(pm);
 
   // Lower Func dialect to LLVM
   pm.addPass(mlir::createConvertFuncToLLVMPass());
@@ -84,6 +135,9 @@ int Backend::lowerDialects() {
   // Finalize the conversion to LLVM dialect
   pm.addPass(mlir::createReconcileUnrealizedCastsPass());
 
+  // Promote scalar allocas now that everything is in the LLVM dialect
+  addLLVMDialectCleanupPasses(pm);
+
   // Run the passes
   if (mlir::failed(pm.run(module))) {
     llvm::errs() << "Pass pipeline failed\n";
@@ -93,11 +147,9 @@ int Backend::lowerDialects() {
 }
 
 void Backend::dumpLLVM(std::ostream &os) {
-  // The only remaining dialects in our module after the passes are builtin
-  // and LLVM. Setup translation patterns to get them to LLVM IR.
-  mlir::registerBuiltinDialectTranslation(context);
-  mlir::registerLLVMDialectTranslation(context);
-  llvm_module = mlir::translateModuleToLLVMIR(module, llvm_context);
+  if (translateToLLVM()) {
+    return;
+  }
 
   // Create llvm ostream and dump into the output file
   llvm::raw_os_ostream output(os);
@@ -114,10 +166,13 @@ void Backend::setupPrintf() const {
   builder->create<mlir::LLVM::LLVMFuncOp>(loc, kPrintfName, llvmFnType);
 }
 
-void Backend::setupScanf() const {
+void Backend::setupReadScalars() const {
+  // Signature: i32 read*(ptr dest), the result is the new stream_state
   auto llvmFnType = mlir::LLVM::LLVMFunctionType::get(intTy(), ptrTy(),
-                                                      /*isVarArg=*/true);
-  builder->create<mlir::LLVM::LLVMFuncOp>(loc, kScanfName, llvmFnType);
+                                                      /*isVarArg=*/false);
+  for (const char *name : {kReadIntName, kReadRealName, kReadCharName, kReadBoolName}) {
+    builder->create<mlir::LLVM::LLVMFuncOp>(loc, name, llvmFnType);
+  }
 }
 
 void Backend::setupIntPow() const {
@@ -177,68 +232,37 @@ void Backend::setupPrintString() const {
                                           llvmFnType);
 }
 
+// Scalars are written to the runtime's output buffer rather than through printf
 void Backend::printFloat(mlir::Value floatValue) {
-  mlir::LLVM::GlobalOp formatString;
-  if (!(formatString = module.lookupSymbol<mlir::LLVM::GlobalOp>("floatFormat"))) {
-    llvm::errs() << "missing format string!\n";
-  }
-  const mlir::Value formatStringPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatString);
-
-  // Convert float (f32) to double (f64) for printf variadic args
-  auto doubleTy = mlir::Float64Type::get(builder->getContext());
-  mlir::Value doubleValue = builder->create<mlir::LLVM::FPExtOp>(loc, doubleTy, floatValue);
-
-  mlir::ValueRange args = {formatStringPtr, doubleValue};
-  auto printfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintfName);
-  builder->create<mlir::LLVM::CallOp>(loc, printfFunc, args);
+  auto printRealFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintRealName);
+  builder->create<mlir::LLVM::CallOp>(loc, printRealFunc, mlir::ValueRange{floatValue});
 }
 
 void Backend::printInt(mlir::Value integer) {
-  mlir::LLVM::GlobalOp formatString;
-  if (!(formatString = module.lookupSymbol<mlir::LLVM::GlobalOp>("intFormat"))) {
-    llvm::errs() << "missing format string!\n";
-  }
-  const mlir::Value formatStringPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatString);
-  mlir::ValueRange args = {formatStringPtr, integer};
-  auto printfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintfName);
-  builder->create<mlir::LLVM::CallOp>(loc, printfFunc, args);
+  auto printIntFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintIntName);
+  builder->create<mlir::LLVM::CallOp>(loc, printIntFunc, mlir::ValueRange{integer});
 }
 
 void Backend::printIntChar(mlir::Value integer) {
-  mlir::LLVM::GlobalOp formatString;
-  if (!(formatString = module.lookupSymbol<mlir::LLVM::GlobalOp>("charFormat"))) {
-    llvm::errs() << "missing format string!\n";
-  }
-  const mlir::Value formatStringPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatString);
-  mlir::ValueRange args = {formatStringPtr, integer};
-  auto printfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintfName);
-  builder->create<mlir::LLVM::CallOp>(loc, printfFunc, args);
+  auto printCharFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintCharName);
+  builder->create<mlir::LLVM::CallOp>(loc, printCharFunc, mlir::ValueRange{integer});
 }
 
 void Backend::printBool(mlir::Value boolValue) {
-  builder->create<mlir::scf::IfOp>(
-      loc, boolValue,
-      [&](mlir::OpBuilder &b, mlir::Location l) {
-        printChar('T');
-        b.create<mlir::scf::YieldOp>(l);
-      },
-      [&](mlir::OpBuilder &b, mlir::Location l) {
-        printChar('F');
-        b.create<mlir::scf::YieldOp>(l);
-      });
+  auto charT = builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), 'T');
+  auto charF = builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), 'F');
+  printIntChar(builder->create<mlir::LLVM::SelectOp>(loc, boolValue, charT, charF));
 }
 
-void Backend::printChar(char c) {
-  mlir::LLVM::GlobalOp formatString;
-  if (!(formatString = module.lookupSymbol<mlir::LLVM::GlobalOp>("charFormat"))) {
-    llvm::errs() << "missing format string!\n";
-  }
-  const mlir::Value formatStringPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatString);
-  const mlir::Value charToPrint =
-      builder->create<mlir::LLVM::ConstantOp>(loc, builder->getI8Type(), c);
-  mlir::ValueRange args = {formatStringPtr, charToPrint};
-  auto printfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kPrintfName);
-  builder->create<mlir::LLVM::CallOp>(loc, printfFunc, args);
+void Backend::setupPrintScalars() const {
+  // Signatures: void printInt(i32), void printReal(f32), void printChar(i8)
+  auto voidType = mlir::LLVM::LLVMVoidType::get(builder->getContext());
+  builder->create<mlir::LLVM::LLVMFuncOp>(
+      loc, kPrintIntName, mlir::LLVM::LLVMFunctionType::get(voidType, {intTy()}, false));
+  builder->create<mlir::LLVM::LLVMFuncOp>(
+      loc, kPrintRealName, mlir::LLVM::LLVMFunctionType::get(voidType, {floatTy()}, false));
+  builder->create<mlir::LLVM::LLVMFuncOp>(
+      loc, kPrintCharName, mlir::LLVM::LLVMFunctionType::get(voidType, {charTy()}, false));
 }
 
 void Backend::printVector(int lineNumber, mlir::Value vectorStructAddr,
@@ -379,6 +403,11 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
                                           std::shared_ptr<symTable::Type> rightType,
                                           mlir::Value incomingLeftAddr,
                                           mlir::Value incomingRightAddr) {
+  // Scalar-element arrays and vectors get one fused loop instead of the per-element recursion below
+  if (auto result = emitElementwiseBinary(op, opType, leftType, rightType, incomingLeftAddr,
+                                          incomingRightAddr)) {
+    return result;
+  }
   // copy values here so casting does not affect the incoming addresses
   mlir::Value leftAddr =
       builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(leftType), constOne());
@@ -610,22 +639,11 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
         combinedType = leftType;
       }
       auto skipByIndex = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), rightAddr);
-      auto isSkipByLessThanOne = builder->create<mlir::LLVM::ICmpOp>(
-          loc, mlir::LLVM::ICmpPredicate::slt, skipByIndex, constOne());
-      builder->create<mlir::scf::IfOp>(
-          loc, isSkipByLessThanOne,
-          [&](mlir::OpBuilder &b, mlir::Location l) {
-            auto throwStrideErrorFunc =
-                module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kThrowStrideErrorName);
-            b.create<mlir::LLVM::CallOp>(l, throwStrideErrorFunc, mlir::ValueRange{});
-            b.create<mlir::scf::YieldOp>(l);
-          },
-          [&](mlir::OpBuilder &b, mlir::Location l) { b.create<mlir::scf::YieldOp>(l); });
-      // Convert vector to array, then stride the array to return an array result
+      throwIfStrideNotPositive(skipByIndex);
+      // Stride the vector's buffer through an array header to return an array result
       auto vectorType = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(leftType);
-      auto [arrayAddr, arrayType] = convertVectorToArrayStruct(leftAddr, vectorType);
+      auto [arrayAddr, arrayType] = viewVectorAsArrayStruct(leftAddr, vectorType);
       auto res = strideArrayByScalar(arrayType, arrayAddr, skipByIndex);
-      freeArray(arrayType, arrayAddr);
       freeAllocatedMemory(leftType, leftAddr);
       freeAllocatedMemory(rightType, rightAddr);
       return res;
@@ -1004,17 +1022,7 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
     auto combinedType = leftType;
     if (op == ast::expressions::BinaryOpType::BY) {
       auto skipByIndex = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), rightAddr);
-      auto isSkipByLessThanOne = builder->create<mlir::LLVM::ICmpOp>(
-          loc, mlir::LLVM::ICmpPredicate::slt, skipByIndex, constOne());
-      builder->create<mlir::scf::IfOp>(
-          loc, isSkipByLessThanOne,
-          [&](mlir::OpBuilder &b, mlir::Location l) {
-            auto throwVectorSizeErrorFunc =
-                module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kThrowStrideErrorName);
-            b.create<mlir::LLVM::CallOp>(l, throwVectorSizeErrorFunc, mlir::ValueRange{});
-            b.create<mlir::scf::YieldOp>(l);
-          },
-          [&](mlir::OpBuilder &b, mlir::Location l) { b.create<mlir::scf::YieldOp>(l); });
+      throwIfStrideNotPositive(skipByIndex);
       // TODO: add casting here
       auto leftShouldBeCasted = isTypeInteger(leftType) && isTypeReal(opType);
       leftAddr = castIntegerArrayToReal(leftAddr, leftType, leftShouldBeCasted);
@@ -1089,6 +1097,11 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
       freeAllocatedMemory(rightType, rightAddr);
       return result;
     } else if (op == ast::expressions::BinaryOpType::DMUL) {
+      if (auto result = emitDotKernel(opType, leftType, rightType, leftAddr, rightAddr)) {
+        freeAllocatedMemory(leftType, leftAddr);
+        freeAllocatedMemory(rightType, rightAddr);
+        return result;
+      }
       // array is multi-dimentional
       if (auto arrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(opType)) {
         auto childType = arrayType->getType();
@@ -1305,6 +1318,9 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
     freeAllocatedMemory(rightType, rightAddr);
     return newAddr;
   } else { // other primitive types
+    if (op == ast::expressions::BinaryOpType::POWER) {
+      return powerOperandToValue(ctx, opType, leftType, rightType, leftAddr, rightAddr);
+    }
     if (leftType->getName() == "real" || rightType->getName() == "real") {
       auto realType = leftType->getName() == "real" ? leftType : rightType;
       if (leftType->getName() != "real") {
@@ -1323,8 +1339,100 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
         builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(opType), constOne());
     auto leftValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(leftType), leftAddr);
     auto rightValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(leftType), rightAddr);
-    mlir::Value result;
+    mlir::Value result = scalarBinaryValue(op, false, leftValue, rightValue);
+
+    builder->create<mlir::LLVM::StoreOp>(loc, result, newAddr);
+    return newAddr;
+  }
+};
+
+mlir::Value Backend::floatBinaryOperandToValue(ast::expressions::BinaryOpType op,
+                                               std::shared_ptr<symTable::Type> opType,
+                                               std::shared_ptr<symTable::Type> leftType,
+                                               std::shared_ptr<symTable::Type> rightType,
+                                               mlir::Value leftAddr, mlir::Value rightAddr) {
+  std::shared_ptr<symTable::Type> operandType;
+  if (leftType->getName() == "real" || rightType->getName() == "real") {
+    operandType = leftType->getName() == "real" ? leftType : rightType;
+  } else {
+    operandType = leftType;
+  }
+
+  auto newAddr =
+      builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(opType), constOne());
+  auto leftValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(operandType), leftAddr);
+  auto rightValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(operandType), rightAddr);
+  mlir::Value result = scalarBinaryValue(op, true, leftValue, rightValue);
+
+  builder->create<mlir::LLVM::StoreOp>(loc, result, newAddr);
+  return newAddr;
+}
 
+mlir::Value Backend::scalarBinaryValue(ast::expressions::BinaryOpType op, bool isReal,
+                                       mlir::Value leftValue, mlir::Value rightValue) {
+  // Both operands are already loaded and promoted to the same type; emits at the builder's
+  // insertion point so element-wise kernels can call this from inside their loop body.
+  mlir::Value result;
+  if (isReal) {
+    switch (op) {
+    case ast::expressions::BinaryOpType::ADD:
+      result = builder->create<mlir::LLVM::FAddOp>(loc, leftValue, rightValue);
+      break;
+    case ast::expressions::BinaryOpType::SUBTRACT:
+      result = builder->create<mlir::LLVM::FSubOp>(loc, leftValue, rightValue);
+      break;
+    case ast::expressions::BinaryOpType::MULTIPLY:
+      result = builder->create<mlir::LLVM::FMulOp>(loc, leftValue, rightValue);
+      break;
+    case ast::expressions::BinaryOpType::DIVIDE: {
+      auto floatZero =
+          builder->create<mlir::LLVM::ConstantOp>(loc, floatTy(), llvm::APFloat(0.0f));
+      auto isZeroCond = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::oeq,
+                                                            rightValue, floatZero);
+      builder->create<mlir::scf::IfOp>(loc, isZeroCond, [&](mlir::OpBuilder &b, mlir::Location l) {
+        auto throwDivByZeroFunc =
+            module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kThrowDivByZeroErrorName);
+        b.create<mlir::LLVM::CallOp>(l, throwDivByZeroFunc, mlir::ValueRange{});
+        b.create<mlir::scf::YieldOp>(l);
+      });
+      result = builder->create<mlir::LLVM::FDivOp>(loc, leftValue, rightValue);
+      break;
+    }
+    case ast::expressions::BinaryOpType::EQUAL:
+      result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::oeq, leftValue,
+                                                   rightValue);
+      break;
+    case ast::expressions::BinaryOpType::NOT_EQUAL:
+      result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::one, leftValue,
+                                                   rightValue);
+      break;
+    case ast::expressions::BinaryOpType::LESS_THAN:
+      result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::olt, leftValue,
+                                                   rightValue);
+      break;
+    case ast::expressions::BinaryOpType::GREATER_THAN:
+      result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::ogt, leftValue,
+                                                   rightValue);
+      break;
+    case ast::expressions::BinaryOpType::LESS_EQUAL:
+      result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::ole, leftValue,
+                                                   rightValue);
+      break;
+    case ast::expressions::BinaryOpType::GREATER_EQUAL:
+      result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::oge, leftValue,
+                                                   rightValue);
+      break;
+    case ast::expressions::BinaryOpType::POWER:
+      result = emitPower(true, leftValue, rightValue);
+      break;
+    case ast::expressions::BinaryOpType::REM:
+      result = builder->create<mlir::LLVM::FRemOp>(loc, leftValue, rightValue);
+      break;
+    default:
+      MathError("Unmatched binary op type");
+      break;
+    }
+  } else {
     switch (op) {
     case ast::expressions::BinaryOpType::ADD:
       result = builder->create<mlir::LLVM::AddOp>(loc, leftValue, rightValue);
@@ -1374,14 +1482,9 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
     case ast::expressions::BinaryOpType::REM:
       result = builder->create<mlir::LLVM::SRemOp>(loc, leftValue, rightValue);
       break;
-    case ast::expressions::BinaryOpType::POWER: {
-      auto ipowFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kIpowName);
-      result =
-          builder
-              ->create<mlir::LLVM::CallOp>(loc, ipowFunc, mlir::ValueRange{leftValue, rightValue})
-              .getResult();
+    case ast::expressions::BinaryOpType::POWER:
+      result = emitPower(false, leftValue, rightValue);
       break;
-    }
     case ast::expressions::BinaryOpType::AND:
       result = builder->create<mlir::LLVM::AndOp>(loc, leftValue, rightValue);
       break;
@@ -1395,91 +1498,8 @@ mlir::Value Backend::binaryOperandToValue(std::shared_ptr<ast::Ast> ctx,
       MathError("Unmatched binary op type");
       break;
     }
-
-    builder->create<mlir::LLVM::StoreOp>(loc, result, newAddr);
-    return newAddr;
   }
-};
-
-mlir::Value Backend::floatBinaryOperandToValue(ast::expressions::BinaryOpType op,
-                                               std::shared_ptr<symTable::Type> opType,
-                                               std::shared_ptr<symTable::Type> leftType,
-                                               std::shared_ptr<symTable::Type> rightType,
-                                               mlir::Value leftAddr, mlir::Value rightAddr) {
-  std::shared_ptr<symTable::Type> operandType;
-  if (leftType->getName() == "real" || rightType->getName() == "real") {
-    operandType = leftType->getName() == "real" ? leftType : rightType;
-  } else {
-    operandType = leftType;
-  }
-
-  auto newAddr =
-      builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(opType), constOne());
-  auto leftValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(operandType), leftAddr);
-  auto rightValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(operandType), rightAddr);
-  mlir::Value result;
-
-  switch (op) {
-  case ast::expressions::BinaryOpType::ADD:
-    result = builder->create<mlir::LLVM::FAddOp>(loc, leftValue, rightValue);
-    break;
-  case ast::expressions::BinaryOpType::SUBTRACT:
-    result = builder->create<mlir::LLVM::FSubOp>(loc, leftValue, rightValue);
-    break;
-  case ast::expressions::BinaryOpType::MULTIPLY:
-    result = builder->create<mlir::LLVM::FMulOp>(loc, leftValue, rightValue);
-    break;
-  case ast::expressions::BinaryOpType::DIVIDE: {
-    auto floatZero =
-        builder->create<mlir::LLVM::ConstantOp>(loc, getMLIRType(operandType), llvm::APFloat(0.0f));
-    auto isZeroCond = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::oeq,
-                                                          rightValue, floatZero);
-    builder->create<mlir::scf::IfOp>(loc, isZeroCond, [&](mlir::OpBuilder &b, mlir::Location l) {
-      auto throwDivByZeroFunc =
-          module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kThrowDivByZeroErrorName);
-      b.create<mlir::LLVM::CallOp>(l, throwDivByZeroFunc, mlir::ValueRange{});
-      b.create<mlir::scf::YieldOp>(l);
-    });
-    result = builder->create<mlir::LLVM::FDivOp>(loc, leftValue, rightValue);
-    break;
-  }
-  case ast::expressions::BinaryOpType::EQUAL:
-    result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::oeq, leftValue,
-                                                 rightValue);
-    break;
-  case ast::expressions::BinaryOpType::NOT_EQUAL:
-    result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::one, leftValue,
-                                                 rightValue);
-    break;
-  case ast::expressions::BinaryOpType::LESS_THAN:
-    result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::olt, leftValue,
-                                                 rightValue);
-    break;
-  case ast::expressions::BinaryOpType::GREATER_THAN:
-    result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::ogt, leftValue,
-                                                 rightValue);
-    break;
-  case ast::expressions::BinaryOpType::LESS_EQUAL:
-    result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::ole, leftValue,
-                                                 rightValue);
-    break;
-  case ast::expressions::BinaryOpType::GREATER_EQUAL:
-    result = builder->create<mlir::LLVM::FCmpOp>(loc, mlir::LLVM::FCmpPredicate::oge, leftValue,
-                                                 rightValue);
-    break;
-  case ast::expressions::BinaryOpType::POWER:
-    result = builder->create<mlir::LLVM::PowOp>(loc, leftValue, rightValue);
-    break;
-  case ast::expressions::BinaryOpType::REM:
-    result = builder->create<mlir::LLVM::FRemOp>(loc, leftValue, rightValue);
-    break;
-  default:
-    MathError("Unmatched binary op type");
-    break;
-  }
-
-  builder->create<mlir::LLVM::StoreOp>(loc, result, newAddr);
-  return newAddr;
+  return result;
 }
 
 mlir::Value Backend::promoteScalarValue(mlir::Value value,
@@ -2095,6 +2115,123 @@ mlir::Value Backend::castIfNeededImpl(std::shared_ptr<ast::Ast> ctx, mlir::Value
   return valueAddr;
 }
 
+namespace {
+bool declaresNoSizes(const std::shared_ptr<ast::types::DataTypeAst> &typeAst) {
+  if (!typeAst) {
+    return false;
+  }
+  switch (typeAst->getNodeType()) {
+  case ast::NodeType::IntegerType:
+  case ast::NodeType::RealType:
+  case ast::NodeType::CharType:
+  case ast::NodeType::BoolType:
+    return true;
+  case ast::NodeType::ArrayType: {
+    const auto arrayAst = std::dynamic_pointer_cast<ast::types::ArrayTypeAst>(typeAst);
+    for (const auto &size : arrayAst->getSizes()) {
+      if (size) {
+        return false;
+      }
+    }
+    return declaresNoSizes(arrayAst->getType());
+  }
+  case ast::NodeType::VectorType:
+    return declaresNoSizes(
+        std::dynamic_pointer_cast<ast::types::VectorTypeAst>(typeAst)->getElementType());
+  case ast::NodeType::TupleType:
+    for (const auto &subType :
+         std::dynamic_pointer_cast<ast::types::TupleTypeAst>(typeAst)->getTypes()) {
+      if (!declaresNoSizes(subType)) {
+        return false;
+      }
+    }
+    return true;
+  case ast::NodeType::StructType:
+    for (const auto &subType :
+         std::dynamic_pointer_cast<ast::types::StructTypeAst>(typeAst)->getTypes()) {
+      if (!declaresNoSizes(subType)) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    // Aliases may stand for sized arrays, so they keep the copying path
+    return false;
+  }
+}
+
+bool hasSameRepresentation(const std::shared_ptr<symTable::Type> &from,
+                           const std::shared_ptr<symTable::Type> &to) {
+  if (!from || !to || from->getName() != to->getName()) {
+    return false;
+  }
+  if (const auto fromArray = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(from)) {
+    const auto toArray = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(to);
+    return toArray && hasSameRepresentation(fromArray->getType(), toArray->getType());
+  }
+  if (const auto fromVector = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(from)) {
+    const auto toVector = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(to);
+    return toVector && hasSameRepresentation(fromVector->getType(), toVector->getType());
+  }
+  std::vector<std::shared_ptr<symTable::Type>> fromElements;
+  std::vector<std::shared_ptr<symTable::Type>> toElements;
+  if (const auto fromTuple = std::dynamic_pointer_cast<symTable::TupleTypeSymbol>(from)) {
+    const auto toTuple = std::dynamic_pointer_cast<symTable::TupleTypeSymbol>(to);
+    if (!toTuple) {
+      return false;
+    }
+    fromElements = fromTuple->getResolvedTypes();
+    toElements = toTuple->getResolvedTypes();
+  } else if (const auto fromStruct = std::dynamic_pointer_cast<symTable::StructTypeSymbol>(from)) {
+    const auto toStruct = std::dynamic_pointer_cast<symTable::StructTypeSymbol>(to);
+    if (!toStruct) {
+      return false;
+    }
+    fromElements = fromStruct->getResolvedTypes();
+    toElements = toStruct->getResolvedTypes();
+  }
+  if (fromElements.size() != toElements.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < fromElements.size(); ++i) {
+    if (!hasSameRepresentation(fromElements[i], toElements[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+bool Backend::releaseTemporary(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                               std::shared_ptr<symTable::Type> type, mlir::Value valueAddr) {
+  if (!expr || isScalarType(type)) {
+    return false;
+  }
+  // Only these results are fresh allocations owned by the scope's free list. Other r-values such
+  // as a field of a const tuple or struct point into storage that stays with its owner.
+  switch (expr->getNodeType()) {
+  case ast::NodeType::FuncProcCall:
+  case ast::NodeType::StructFuncCallRouter:
+  case ast::NodeType::ArrayLiteral:
+  case ast::NodeType::TupleLiteral:
+  case ast::NodeType::StructLiteral:
+  case ast::NodeType::BinaryExpression:
+  case ast::NodeType::Generator:
+  case ast::NodeType::Range:
+    break;
+  default:
+    return false;
+  }
+  expr->getScope()->removeElementToFree(valueAddr);
+  return true;
+}
+
+bool Backend::canPassByReference(const std::shared_ptr<ast::types::DataTypeAst> &paramTypeAst,
+                                 std::shared_ptr<symTable::Type> argType,
+                                 std::shared_ptr<symTable::Type> paramType) {
+  return declaresNoSizes(paramTypeAst) && hasSameRepresentation(argType, paramType);
+}
+
 void Backend::copyValue(std::shared_ptr<symTable::Type> type, mlir::Value fromAddr,
                         mlir::Value destAddr) {
   if (type->getName() == "tuple") {
@@ -2162,156 +2299,24 @@ bool Backend::isScalarType(std::shared_ptr<symTable::Type> type) const {
   return name == "integer" || name == "real" || name == "character" || name == "boolean";
 }
 
-void Backend::readInteger(mlir::Value destAddr) {
-  if (!destAddr) {
-    return;
-  }
-  auto scanfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kScanfName);
-  if (!scanfFunc) {
-    return;
-  }
-  auto zeroValue = constZero();
-  builder->create<mlir::LLVM::StoreOp>(loc, zeroValue, destAddr);
-  auto formatGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>("intInputFormat");
-  auto formatPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatGlobal);
-  auto call =
-      builder->create<mlir::LLVM::CallOp>(loc, scanfFunc, mlir::ValueRange{formatPtr, destAddr});
-  auto result = call.getResult();
-
-  auto streamGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>(kStreamStateGlobalName);
-  auto streamStatePtr = builder->create<mlir::LLVM::AddressOfOp>(loc, streamGlobal);
-
-  auto minusOne = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), -1);
-  auto twoConst = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 2);
-  auto zeroConst = constZero();
-  auto oneConst = constOne();
-  auto isEOF =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, minusOne);
-  auto isSuccess =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, oneConst);
-  auto stateWhenNotEOF = builder->create<mlir::LLVM::SelectOp>(loc, isSuccess, zeroConst, oneConst);
-  auto finalState = builder->create<mlir::LLVM::SelectOp>(loc, isEOF, twoConst, stateWhenNotEOF);
-  builder->create<mlir::LLVM::StoreOp>(loc, finalState, streamStatePtr);
-}
-
-void Backend::readReal(mlir::Value destAddr) {
-  if (!destAddr) {
-    return;
-  }
-  auto scanfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kScanfName);
-  if (!scanfFunc) {
-    return;
-  }
-  auto zeroFloat = builder->create<mlir::LLVM::ConstantOp>(loc, floatTy(),
-                                                           builder->getFloatAttr(floatTy(), 0.0));
-  builder->create<mlir::LLVM::StoreOp>(loc, zeroFloat, destAddr);
-  auto formatGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>("floatInputFormat");
-  auto formatPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatGlobal);
-  auto call =
-      builder->create<mlir::LLVM::CallOp>(loc, scanfFunc, mlir::ValueRange{formatPtr, destAddr});
-  auto result = call.getResult();
-
-  auto streamGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>(kStreamStateGlobalName);
-  auto streamStatePtr = builder->create<mlir::LLVM::AddressOfOp>(loc, streamGlobal);
-
-  auto minusOne = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), -1);
-  auto twoConst = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 2);
-  auto zeroConst = constZero();
-  auto oneConst = constOne();
-  auto isEOF =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, minusOne);
-  auto isSuccess =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, oneConst);
-  auto stateWhenNotEOF = builder->create<mlir::LLVM::SelectOp>(loc, isSuccess, zeroConst, oneConst);
-  auto finalState = builder->create<mlir::LLVM::SelectOp>(loc, isEOF, twoConst, stateWhenNotEOF);
-  builder->create<mlir::LLVM::StoreOp>(loc, finalState, streamStatePtr);
-}
-
-void Backend::readCharacter(mlir::Value destAddr) {
-  if (!destAddr) {
-    return;
-  }
-  auto scanfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kScanfName);
-  if (!scanfFunc) {
-    return;
-  }
-  auto formatGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>("charInputFormat");
-  auto formatPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatGlobal);
-  auto call =
-      builder->create<mlir::LLVM::CallOp>(loc, scanfFunc, mlir::ValueRange{formatPtr, destAddr});
-  auto result = call.getResult();
+void Backend::readInteger(mlir::Value destAddr) { readScalar(kReadIntName, destAddr); }
 
-  auto streamGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>(kStreamStateGlobalName);
-  auto streamStatePtr = builder->create<mlir::LLVM::AddressOfOp>(loc, streamGlobal);
+void Backend::readReal(mlir::Value destAddr) { readScalar(kReadRealName, destAddr); }
 
-  auto minusOne = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), -1);
-  auto twoConst = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 2);
-  auto zeroConst = constZero();
-  auto isEOF =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, minusOne);
-  auto charMinusOne = builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), -1);
-  auto currentValue = builder->create<mlir::LLVM::LoadOp>(loc, charTy(), destAddr);
-  auto finalChar = builder->create<mlir::LLVM::SelectOp>(loc, isEOF, charMinusOne, currentValue);
-  builder->create<mlir::LLVM::StoreOp>(loc, finalChar, destAddr);
+void Backend::readCharacter(mlir::Value destAddr) { readScalar(kReadCharName, destAddr); }
 
-  auto finalState = builder->create<mlir::LLVM::SelectOp>(loc, isEOF, twoConst, zeroConst);
-  builder->create<mlir::LLVM::StoreOp>(loc, finalState, streamStatePtr);
-}
+void Backend::readBoolean(mlir::Value destAddr) { readScalar(kReadBoolName, destAddr); }
 
-void Backend::readBoolean(mlir::Value destAddr) {
+void Backend::readScalar(const char *readFuncName, mlir::Value destAddr) {
   if (!destAddr) {
     return;
   }
-  auto scanfFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kScanfName);
-  if (!scanfFunc) {
-    return;
-  }
-  auto defaultBoolFalse = builder->create<mlir::LLVM::ConstantOp>(loc, boolTy(), 0);
-  builder->create<mlir::LLVM::StoreOp>(loc, defaultBoolFalse, destAddr);
-  auto formatGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>("boolInputFormat");
-  auto formatPtr = builder->create<mlir::LLVM::AddressOfOp>(loc, formatGlobal);
-  auto tempChar = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), charTy(), constOne());
-  auto defaultChar = builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), 'F');
-  builder->create<mlir::LLVM::StoreOp>(loc, defaultChar, tempChar);
-  auto call =
-      builder->create<mlir::LLVM::CallOp>(loc, scanfFunc, mlir::ValueRange{formatPtr, tempChar});
-  auto result = call.getResult();
-
+  // The runtime reader stores the value (or its default on failure) and returns the stream_state
+  auto readFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(readFuncName);
+  auto call = builder->create<mlir::LLVM::CallOp>(loc, readFunc, mlir::ValueRange{destAddr});
   auto streamGlobal = module.lookupSymbol<mlir::LLVM::GlobalOp>(kStreamStateGlobalName);
   auto streamStatePtr = builder->create<mlir::LLVM::AddressOfOp>(loc, streamGlobal);
-
-  auto minusOne = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), -1);
-  auto twoConst = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 2);
-  auto zeroConst = constZero();
-  auto oneConst = constOne();
-  auto isEOF =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, minusOne);
-  auto isSuccess =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, result, oneConst);
-
-  auto readValue = builder->create<mlir::LLVM::LoadOp>(loc, charTy(), tempChar);
-  auto tConst = builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), 'T');
-  auto fConst = builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), 'F');
-  auto isTrueChar =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, readValue, tConst);
-  auto isFalseChar =
-      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq, readValue, fConst);
-  auto isValid = builder->create<mlir::LLVM::OrOp>(loc, isTrueChar, isFalseChar);
-
-  auto boolTrue = builder->create<mlir::LLVM::ConstantOp>(loc, boolTy(), 1);
-  auto boolFalse = builder->create<mlir::LLVM::ConstantOp>(loc, boolTy(), 0);
-  auto boolFromChar = builder->create<mlir::LLVM::SelectOp>(loc, isTrueChar, boolTrue, boolFalse);
-  auto boolWhenValid = builder->create<mlir::LLVM::SelectOp>(loc, isValid, boolFromChar, boolFalse);
-  auto boolWhenSuccess =
-      builder->create<mlir::LLVM::SelectOp>(loc, isSuccess, boolWhenValid, boolFalse);
-  auto finalBool = builder->create<mlir::LLVM::SelectOp>(loc, isEOF, boolFalse, boolWhenSuccess);
-  builder->create<mlir::LLVM::StoreOp>(loc, finalBool, destAddr);
-
-  auto stateOnSuccess = builder->create<mlir::LLVM::SelectOp>(loc, isValid, zeroConst, oneConst);
-  auto stateWhenNotEOF =
-      builder->create<mlir::LLVM::SelectOp>(loc, isSuccess, stateOnSuccess, oneConst);
-  auto finalState = builder->create<mlir::LLVM::SelectOp>(loc, isEOF, twoConst, stateWhenNotEOF);
-  builder->create<mlir::LLVM::StoreOp>(loc, finalState, streamStatePtr);
+  builder->create<mlir::LLVM::StoreOp>(loc, call.getResult(), streamStatePtr);
 }
 
 void Backend::pushElementToScopeStack(std::shared_ptr<ast::Ast> ctx,
@@ -0,0 +1,347 @@
+#include "backend/Backend.h"
+
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/TargetParser/Host.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace gazprea::backend {
+
+namespace {
+// Reports how many operations each pass leaves behind and how long it took.
+class PassReportInstrumentation final : public mlir::PassInstrumentation {
+public:
+  explicit PassReportInstrumentation(llvm::raw_ostream &os) : os(os) {}
+
+  void runBeforePass(mlir::Pass *pass, mlir::Operation *op) override {
+    running.push_back({countOps(op), std::chrono::steady_clock::now()});
+  }
+
+  void runAfterPass(mlir::Pass *pass, mlir::Operation *op) override { report(pass, op, ""); }
+
+  void runAfterPassFailed(mlir::Pass *pass, mlir::Operation *op) override {
+    report(pass, op, " (failed)");
+  }
+
+private:
+  struct PassStart {
+    size_t opsBefore;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  static size_t countOps(mlir::Operation *root) {
+    size_t count = 0;
+    root->walk([&count](mlir::Operation *) { ++count; });
+    return count;
+  }
+
+  void report(mlir::Pass *pass, mlir::Operation *op, llvm::StringRef suffix) {
+    const auto [opsBefore, start] = running.back();
+    running.pop_back();
+    const std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const size_t opsAfter = countOps(op);
+    os << llvm::format("%-40s %8zu -> %8zu ops (%+8lld) %10.3f ms", pass->getName().str().c_str(),
+                       opsBefore, opsAfter,
+                       static_cast<long long>(opsAfter) - static_cast<long long>(opsBefore),
+                       elapsed.count())
+       << suffix << "\n";
+  }
+
+  llvm::raw_ostream &os;
+  std::vector<PassStart> running;
+};
+} // namespace
+
+void Backend::addPassReport(mlir::PassManager &pm) const {
+  llvm::errs() << llvm::format("%-40s %8s    %8s %14s %13s\n", "pass", "before", "after", "delta",
+                               "time");
+  pm.addInstrumentation(std::make_unique<PassReportInstrumentation>(llvm::errs()));
+}
+
+void Backend::addMLIROptimizationPasses(mlir::PassManager &pm) const {
+  if (optLevel == 0) {
+    return;
+  }
+  // Folds the many duplicated constOne()/constZero() constants and trivial arith.
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::createCSEPass());
+  if (optLevel >= 2) {
+    // scf.for bodies recompute sizes and addresses that do not depend on the induction variable.
+    pm.addPass(mlir::createLoopInvariantCodeMotionPass());
+    pm.addPass(mlir::createCanonicalizerPass());
+  }
+}
+
+void Backend::addLLVMDialectCleanupPasses(mlir::PassManager &pm) const {
+  if (optLevel == 0) {
+    return;
+  }
+  // Every expression result lives in an alloca; split aggregates then promote the scalars.
+  pm.addPass(mlir::createSROA());
+  pm.addPass(mlir::createMem2Reg());
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::createCSEPass());
+}
+
+int Backend::translateToLLVM() {
+  if (llvm_module) {
+    return 0;
+  }
+  llvm_module = translateToLLVM(llvm_context);
+  return llvm_module ? 0 : 1;
+}
+
+std::unique_ptr<llvm::Module> Backend::translateToLLVM(llvm::LLVMContext &targetContext) {
+  // The only remaining dialects in our module after the passes are builtin
+  // and LLVM. Setup translation patterns to get them to LLVM IR.
+  mlir::registerBuiltinDialectTranslation(context);
+  mlir::registerLLVMDialectTranslation(context);
+  auto llvmModule = mlir::translateModuleToLLVMIR(module, targetContext);
+  if (!llvmModule) {
+    llvm::errs() << "Failed to translate module to LLVM IR\n";
+    return nullptr;
+  }
+
+  // Give the module the host layout so the optimizer (and the vectorizer in particular) can make
+  // decisions using the real target costs instead of the generic defaults.
+  if (!targetMachine) {
+    targetMachine = createHostTargetMachine();
+  }
+  if (targetMachine) {
+    llvmModule->setTargetTriple(targetMachine->getTargetTriple().str());
+    llvmModule->setDataLayout(targetMachine->createDataLayout());
+  }
+
+  optimizeLLVM(*llvmModule);
+  return llvmModule;
+}
+
+std::unique_ptr<llvm::TargetMachine> Backend::createHostTargetMachine() const {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  const auto triple = llvm::sys::getDefaultTargetTriple();
+  std::string error;
+  const auto *target = llvm::TargetRegistry::lookupTarget(triple, error);
+  if (!target) {
+    llvm::errs() << "Failed to find host target: " << error << "\n";
+    return nullptr;
+  }
+
+  llvm::CodeGenOptLevel codeGenLevel = llvm::CodeGenOptLevel::None;
+  switch (optLevel) {
+  case 0:
+    codeGenLevel = llvm::CodeGenOptLevel::None;
+    break;
+  case 1:
+    codeGenLevel = llvm::CodeGenOptLevel::Less;
+    break;
+  case 2:
+    codeGenLevel = llvm::CodeGenOptLevel::Default;
+    break;
+  default:
+    codeGenLevel = llvm::CodeGenOptLevel::Aggressive;
+    break;
+  }
+
+  llvm::TargetOptions options;
+  return std::unique_ptr<llvm::TargetMachine>(
+      target->createTargetMachine(triple, llvm::sys::getHostCPUName(), "", options,
+                                  llvm::Reloc::PIC_, std::nullopt, codeGenLevel));
+}
+
+llvm::OptimizationLevel Backend::getLLVMOptLevel() const {
+  switch (optLevel) {
+  case 0:
+    return llvm::OptimizationLevel::O0;
+  case 1:
+    return llvm::OptimizationLevel::O1;
+  case 2:
+    return llvm::OptimizationLevel::O2;
+  default:
+    return llvm::OptimizationLevel::O3;
+  }
+}
+
+void Backend::optimizeLLVM(llvm::Module &llvmModule) {
+  if (optLevel == 0) {
+    return;
+  }
+
+  // Standard new-pass-manager setup, the analysis managers must outlive the pass run.
+  llvm::LoopAnalysisManager lam;
+  llvm::FunctionAnalysisManager fam;
+  llvm::CGSCCAnalysisManager cgam;
+  llvm::ModuleAnalysisManager mam;
+
+  llvm::PipelineTuningOptions tuningOptions;
+  tuningOptions.LoopVectorization = true;
+  tuningOptions.SLPVectorization = optLevel >= 2;
+  tuningOptions.LoopUnrolling = true;
+
+  llvm::PassBuilder passBuilder(targetMachine.get(), tuningOptions);
+  passBuilder.registerModuleAnalyses(mam);
+  passBuilder.registerCGSCCAnalyses(cgam);
+  passBuilder.registerFunctionAnalyses(fam);
+  passBuilder.registerLoopAnalyses(lam);
+  passBuilder.crossRegisterProxies(lam, fam, cgam, mam);
+
+  auto mpm = passBuilder.buildPerModuleDefaultPipeline(getLLVMOptLevel());
+  mpm.run(llvmModule, mam);
+
+  if (llvm::verifyModule(llvmModule, &llvm::errs())) {
+    llvm::errs() << "LLVM module failed to verify after optimization\n";
+  }
+}
+
+int Backend::emitObject(const std::string &path) {
+  if (translateToLLVM()) {
+    return 1;
+  }
+  if (!targetMachine) {
+    llvm::errs() << "No target machine available for object emission\n";
+    return 1;
+  }
+
+  std::error_code ec;
+  llvm::raw_fd_ostream dest(path, ec, llvm::sys::fs::OF_None);
+  if (ec) {
+    llvm::errs() << "Could not open " << path << ": " << ec.message() << "\n";
+    return 1;
+  }
+
+  // Codegen still only exists on the legacy pass manager.
+  llvm::legacy::PassManager codeGenPasses;
+  if (targetMachine->addPassesToEmitFile(codeGenPasses, dest, nullptr,
+                                         llvm::CodeGenFileType::ObjectFile)) {
+    llvm::errs() << "Target machine cannot emit object files\n";
+    return 1;
+  }
+  codeGenPasses.run(*llvm_module);
+  dest.flush();
+  return 0;
+}
+
+int Backend::linkExecutable(const std::string &objectPath, const std::string &exePath,
+                            const std::string &runtimeDir) const {
+  // LLVM has no in-library linker, so hand the object to the system driver once.
+  // This replaces the separate llc and clang steps of the old toolchain.
+  auto linker = llvm::sys::findProgramByName("clang");
+  if (!linker) {
+    linker = llvm::sys::findProgramByName("cc");
+  }
+  if (!linker) {
+    llvm::errs() << "Could not find clang or cc to link the executable\n";
+    return 1;
+  }
+
+  const std::string libDirFlag = "-L" + runtimeDir;
+  const std::string rpathFlag = "-Wl,-rpath," + runtimeDir;
+  llvm::SmallVector<llvm::StringRef, 8> args = {*linker,    objectPath, "-o",   exePath,
+                                                libDirFlag, rpathFlag,  "-lgazrt", "-lm"};
+  std::string error;
+  const int status = llvm::sys::ExecuteAndWait(*linker, args, std::nullopt, {}, 0, 0, &error);
+  if (status != 0) {
+    llvm::errs() << "Linking failed" << (error.empty() ? "" : ": " + error) << "\n";
+    return 1;
+  }
+  return 0;
+}
+
+int Backend::runJIT(const std::string &runtimeDir, int &exitCode) {
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  // LLJIT takes ownership of the module and its context, so translate into a fresh context rather
+  // than handing over llvm_context.
+  auto jitContext = std::make_unique<llvm::LLVMContext>();
+  auto jitModule = translateToLLVM(*jitContext);
+  if (!jitModule) {
+    return 1;
+  }
+
+  auto jitBuilder = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!jitBuilder) {
+    llvm::errs() << "Failed to detect host: " << llvm::toString(jitBuilder.takeError()) << "\n";
+    return 1;
+  }
+  jitBuilder->setCodeGenOptLevel(targetMachine ? targetMachine->getOptLevel()
+                                               : llvm::CodeGenOptLevel::None);
+  auto jit = llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*jitBuilder)).create();
+  if (!jit) {
+    llvm::errs() << "Failed to create JIT: " << llvm::toString(jit.takeError()) << "\n";
+    return 1;
+  }
+  jitModule->setDataLayout((*jit)->getDataLayout());
+
+  // The hashed runtime symbols (printf, malloc, throw*...) live in libgazrt, everything else
+  // (libc, libm) comes from the gazc process itself.
+  auto &mainDylib = (*jit)->getMainJITDylib();
+  const char prefix = (*jit)->getDataLayout().getGlobalPrefix();
+  auto processSymbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(prefix);
+  if (!processSymbols) {
+    llvm::errs() << llvm::toString(processSymbols.takeError()) << "\n";
+    return 1;
+  }
+  mainDylib.addGenerator(std::move(*processSymbols));
+
+  bool foundRuntime = false;
+  for (const char *libName : {"libgazrt.so", "libgazrt.dylib"}) {
+    llvm::SmallString<256> libPath(runtimeDir);
+    llvm::sys::path::append(libPath, libName);
+    if (!llvm::sys::fs::exists(libPath)) {
+      continue;
+    }
+    auto runtimeSymbols = llvm::orc::DynamicLibrarySearchGenerator::Load(libPath.c_str(), prefix);
+    if (!runtimeSymbols) {
+      llvm::errs() << llvm::toString(runtimeSymbols.takeError()) << "\n";
+      return 1;
+    }
+    mainDylib.addGenerator(std::move(*runtimeSymbols));
+    foundRuntime = true;
+    break;
+  }
+  if (!foundRuntime) {
+    llvm::errs() << "Could not find libgazrt in " << runtimeDir << "\n";
+    return 1;
+  }
+
+  if (auto err = (*jit)->addIRModule(
+          llvm::orc::ThreadSafeModule(std::move(jitModule), std::move(jitContext)))) {
+    llvm::errs() << llvm::toString(std::move(err)) << "\n";
+    return 1;
+  }
+
+  auto mainSymbol = (*jit)->lookup("main");
+  if (!mainSymbol) {
+    llvm::errs() << llvm::toString(mainSymbol.takeError()) << "\n";
+    return 1;
+  }
+
+  // stdin/stdout are shared with gazc, so the program reads and writes them directly.
+  auto *programMain = mainSymbol->toPtr<int (*)()>();
+  exitCode = programMain();
+  // Output is buffered in libgazrt until exit, which is gazc's exit here
+  if (auto flushSymbol = (*jit)->lookup(kFlushOutputName)) {
+    flushSymbol->toPtr<void (*)()>()();
+  } else {
+    llvm::consumeError(flushSymbol.takeError());
+  }
+  std::fflush(stdout);
+  return 0;
+}
+
+} // namespace gazprea::backend
@@ -5,9 +5,14 @@
 namespace gazprea::backend {
 
 std::any Backend::visitArrayAccess(std::shared_ptr<ast::expressions::ArrayAccessAst> ctx) {
+  // A var argument like `a[i]` hands the callee a pointer into the buffer of `a`
+  const bool isWrittenThrough = evaluatingVarArg && ctx->isLValue();
   visit(ctx->getArrayInstance());
   auto [arrayInstanceType, arrayInstanceAddr] = popElementFromStack(ctx);
   visit(ctx->getElementIndex());
+  if (isWrittenThrough) {
+    makeBufferUnique(arrayInstanceType, arrayInstanceAddr);
+  }
 
   auto vectorTypeSym = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(arrayInstanceType);
   if (vectorTypeSym) {
@@ -30,7 +35,7 @@ std::any Backend::visitArrayAccess(std::shared_ptr<ast::expressions::ArrayAccess
       auto dataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr).getResult();
 
       handleRangedIndexAccess(ctx, arrayInstanceType, arrayInstanceAddr, vectorSize, dataPtr,
-                              vectorStructType);
+                              vectorStructType, isWrittenThrough);
     }
     return {};
   }
@@ -58,7 +63,7 @@ std::any Backend::visitArrayAccess(std::shared_ptr<ast::expressions::ArrayAccess
     mlir::Value dataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr).getResult();
 
     handleRangedIndexAccess(ctx, arrayInstanceType, arrayInstanceAddr, arraySize, dataPtr,
-                            arrayStructType);
+                            arrayStructType, isWrittenThrough);
   }
 
   return {};
@@ -93,7 +98,8 @@ void Backend::handleSingularIndexAccess(std::shared_ptr<ast::expressions::ArrayA
 void Backend::handleRangedIndexAccess(std::shared_ptr<ast::expressions::ArrayAccessAst> ctx,
                                       std::shared_ptr<symTable::Type> instanceType,
                                       mlir::Value instanceAddr, mlir::Value size,
-                                      mlir::Value dataPtr, mlir::Type structType) {
+                                      mlir::Value dataPtr, mlir::Type structType,
+                                      bool isWrittenThrough) {
   std::shared_ptr<symTable::Type> rightIndexType;
   mlir::Value rightIndexAddr;
   bool hasRight = false;
@@ -183,7 +189,9 @@ void Backend::handleRangedIndexAccess(std::shared_ptr<ast::expressions::ArrayAcc
   }
   mlir::Type elementMLIRType = getMLIRType(elementType);
 
-  if (ctx->isLValue()) {
+  // Reads of a variable's slice of scalars are views like rvalue slices, since copies of a pointer
+  // into the variable's buffer would see later writes to the variable
+  if (ctx->isLValue() && (isWrittenThrough || !isSharableType(instanceType))) {
     // LValue semantics: point into original data (no copy).
     // compute srcStart = &dataPtr[normLeft]
     auto srcStartOp = builder->create<mlir::LLVM::GEPOp>(loc, ptrTy(), elementMLIRType, dataPtr,
@@ -200,7 +208,14 @@ void Backend::handleRangedIndexAccess(std::shared_ptr<ast::expressions::ArrayAcc
                                                          mlir::ValueRange{normLeft});
     mlir::Value srcStart = srcStartOp.getResult();
 
-    if (isVector) {
+    if (isSharableType(instanceType)) {
+      // A slice of scalars is a view into the original buffer, which the runtime keeps alive
+      // until the view is freed. Writers copy it first like any shared buffer.
+      auto sliceBytes = getByteCount(*builder, loc, elementMLIRType, sliceSize);
+      auto viewPtr = builder->create<mlir::LLVM::CallOp>(
+          loc, getOrCreateBufferViewFunc(), mlir::ValueRange{dataPtr, srcStart, sliceBytes});
+      builder->create<mlir::LLVM::StoreOp>(loc, viewPtr.getResult(), sliceDataAddr);
+    } else if (isVector) {
       // Allocate new data buffer
       auto newDataPtr = mallocArray(elementMLIRType, sliceSize);
       builder->create<mlir::LLVM::StoreOp>(loc, newDataPtr, sliceDataAddr);
@@ -222,6 +237,10 @@ void Backend::handleRangedIndexAccess(std::shared_ptr<ast::expressions::ArrayAcc
       builder->create<mlir::LLVM::StoreOp>(loc, destDataPtr, sliceDataAddr);
     }
 
+    if (ctx->isLValue()) {
+      // Consumers only free rvalues, so the scope releases the view of a variable
+      ctx->getScope()->pushElementToFree({instanceType, sliceStructAlloca});
+    }
     pushElementToScopeStack(ctx, instanceType, sliceStructAlloca);
   }
 }
@@ -1,8 +1,13 @@
 #include "backend/Backend.h"
+#include "symTable/ArrayTypeSymbol.h"
+#include "symTable/VectorTypeSymbol.h"
 
 namespace gazprea::backend {
 
 std::any Backend::visitBinary(std::shared_ptr<ast::expressions::BinaryAst> ctx) {
+  if (tryEmitFusedExpression(ctx)) {
+    return {};
+  }
   visit(ctx->getLeft());
   auto [leftType, leftAddr] = popElementFromStack(ctx);
   visit(ctx->getRight());
@@ -29,4 +34,71 @@ std::any Backend::visitBinary(std::shared_ptr<ast::expressions::BinaryAst> ctx)
   return {};
 }
 
+namespace {
+std::shared_ptr<symTable::Type> containerElementType(const std::shared_ptr<symTable::Type> &type) {
+  if (const auto arrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(type)) {
+    return arrayType->getType();
+  }
+  return std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(type)->getType();
+}
+} // namespace
+
+std::shared_ptr<ast::expressions::BinaryAst>
+Backend::getStrideDomain(const std::shared_ptr<ast::expressions::DomainExprAst> &domainExpr) const {
+  auto stride = std::dynamic_pointer_cast<ast::expressions::BinaryAst>(
+      domainExpr->getDomainExpression());
+  if (!stride || stride->getBinaryOpType() != ast::expressions::BinaryOpType::BY) {
+    return nullptr;
+  }
+  // Elements are read straight out of the operand, so it must not need a cast to the result type
+  const auto operandType = stride->getLeft()->getInferredSymbolType();
+  const auto resultType = stride->getInferredSymbolType();
+  if (!isSharableType(operandType) || !isSharableType(resultType) ||
+      containerElementType(operandType)->getName() != containerElementType(resultType)->getName()) {
+    return nullptr;
+  }
+  return stride;
+}
+
+// Evaluates both operands once. With `snapshot`, a variable operand is shared into a snapshot the
+// loop body cannot change, since writes to the variable copy its buffer first.
+Backend::StrideDomain
+Backend::emitStrideDomain(const std::shared_ptr<ast::expressions::BinaryAst> &stride,
+                          bool snapshot) {
+  visit(stride->getLeft());
+  auto [operandType, operandAddr] = popElementFromStack(stride->getLeft());
+  visit(stride->getRight());
+  auto [stepType, stepAddr] = popElementFromStack(stride->getRight());
+
+  StrideDomain domain;
+  domain.type = operandType;
+  domain.step = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), stepAddr);
+  throwIfStrideNotPositive(domain.step);
+
+  if (!stride->getLeft()->isLValue()) {
+    // A temporary operand is freed by the caller once the loop is done with it
+    stride->getLeft()->getScope()->removeElementToFree(operandAddr);
+    domain.addr = operandAddr;
+  } else if (snapshot) {
+    domain.addr =
+        builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(operandType), constOne());
+    shareValue(operandType, operandAddr, domain.addr);
+    operandAddr = domain.addr;
+  }
+
+  auto structType = getMLIRType(operandType);
+  mlir::Value sizeAddr, dataAddr;
+  if (isTypeVector(operandType)) {
+    sizeAddr = gepOpVector(structType, operandAddr, VectorOffset::Size);
+    dataAddr = gepOpVector(structType, operandAddr, VectorOffset::Data);
+  } else {
+    sizeAddr = getArraySizeAddr(*builder, loc, structType, operandAddr);
+    dataAddr = getArrayDataAddr(*builder, loc, structType, operandAddr);
+  }
+  auto size = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), sizeAddr);
+  domain.dataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr);
+  domain.count = getStridedCount(size, domain.step);
+  return domain;
+}
+
 } // namespace gazprea::backend
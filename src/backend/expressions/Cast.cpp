@@ -3,6 +3,9 @@
 namespace gazprea::backend {
 
 std::any Backend::visitCast(std::shared_ptr<ast::expressions::CastAst> ctx) {
+  if (tryEmitFusedExpression(ctx)) {
+    return {};
+  }
   visit(ctx->getExpression());
   auto [exprType, exprAddr] = popElementFromStack(ctx);
 
@@ -13,7 +13,8 @@ std::any Backend::visitDomainExpr(std::shared_ptr<ast::expressions::DomainExprAs
   auto copy_addr =
       builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(original_type), constOne());
 
-  copyValue(original_type, original_addr, copy_addr);
+  // The loop reads a snapshot of the domain; writes to the original copy its buffer first
+  shareValue(original_type, original_addr, copy_addr);
 
   if (!innerExpr->isLValue()) {
     freeAllocatedMemory(original_type, original_addr);
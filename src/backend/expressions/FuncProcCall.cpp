@@ -1,9 +1,13 @@
+#include "ast/prototypes/FunctionAst.h"
 #include "ast/prototypes/FunctionParamAst.h"
 #include "ast/prototypes/ProcedureParamAst.h"
+#include "ast/statements/BlockAst.h"
+#include "ast/statements/ReturnAst.h"
 #include "ast/types/ArrayTypeAst.h"
 #include "ast/types/StructTypeAst.h"
 #include "ast/types/TupleTypeAst.h"
 #include "ast/types/VectorTypeAst.h"
+#include "ast/walkers/ValidationWalker.h"
 #include "backend/Backend.h"
 #include "symTable/ArrayTypeSymbol.h"
 #include "symTable/MethodSymbol.h"
@@ -12,10 +16,15 @@
 #include "symTable/VariableSymbol.h"
 #include "symTable/VectorTypeSymbol.h"
 
+#include <algorithm>
+
 namespace gazprea::backend {
 
 std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCallAst> ctx) {
   const auto methodSym = std::dynamic_pointer_cast<symTable::MethodSymbol>(ctx->getSymbol());
+  if (emitInlinedCall(ctx, methodSym)) {
+    return {};
+  }
 
   std::shared_ptr<ast::prototypes::PrototypeAst> protoType;
   if (methodSym->getScopeType() == symTable::ScopeType::Procedure) {
@@ -30,6 +39,7 @@ std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCa
   const auto params = protoType->getParams();
   const auto args = ctx->getArgs();
   std::vector<mlir::Value> mlirArgs;
+  std::vector<bool> passedByReference(args.size(), false);
 
   auto emitSizeErrorIf = [&](mlir::Value predicate) {
     builder->create<mlir::scf::IfOp>(
@@ -187,12 +197,13 @@ std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCa
       };
 
   for (size_t i = 0; i < ctx->getArgs().size(); ++i) {
-    visit(args[i]);
-    auto [valueType, valueAddr] = popElementFromStack(args[i]);
     auto variableSymbol =
         std::dynamic_pointer_cast<symTable::VariableSymbol>(params[i]->getSymbol());
-
     const bool isVarParam = variableSymbol && variableSymbol->getQualifier() == ast::Qualifier::Var;
+    evaluatingVarArg = isVarParam;
+    visit(args[i]);
+    evaluatingVarArg = false;
+    auto [valueType, valueAddr] = popElementFromStack(args[i]);
     auto procParamAst = std::dynamic_pointer_cast<ast::prototypes::ProcedureParamAst>(params[i]);
     auto funcParamAst = std::dynamic_pointer_cast<ast::prototypes::FunctionParamAst>(params[i]);
     std::shared_ptr<ast::types::DataTypeAst> paramTypeAst;
@@ -206,7 +217,14 @@ std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCa
       checkSizes(paramTypeAst, valueType, valueAddr);
     }
 
-    if (variableSymbol->getQualifier() == ast::Qualifier::Const) {
+    if (variableSymbol->getQualifier() == ast::Qualifier::Const &&
+        canPassByReference(paramTypeAst, valueType, variableSymbol->getType())) {
+      // Const params are never written, so the callee reads the argument where it lives. It stays
+      // owned by the caller: a variable, or a temporary freed with the caller's scope.
+      params[i]->getSymbol()->value = valueAddr;
+      mlirArgs.push_back(valueAddr);
+      passedByReference[i] = true;
+    } else if (variableSymbol->getQualifier() == ast::Qualifier::Const) {
       // Param is const
       auto argSymbol = args[i]->getSymbol();
       auto argVarSymbol = std::dynamic_pointer_cast<symTable::VariableSymbol>(argSymbol);
@@ -216,20 +234,21 @@ std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCa
         params[i]->getSymbol()->value = builder->create<mlir::LLVM::AllocaOp>(
             loc, ptrTy(), getMLIRType(variableSymbol->getType()), constOne());
         valueAddr = castIfNeeded(params[i], valueAddr, valueType, variableSymbol->getType());
-        copyValue(variableSymbol->getType(), valueAddr, params[i]->getSymbol()->value);
+        shareValue(variableSymbol->getType(), valueAddr, params[i]->getSymbol()->value);
         mlirArgs.push_back(params[i]->getSymbol()->value);
         freeAllocatedMemory(variableSymbol->getType(), valueAddr);
       } else {
-        // arg is var: copy var, cast the copy, copy the copy into param, free the copy
+        // arg is var: copy var, cast the copy, copy the copy into param, free the copy. Casts of
+        // arrays reallocate, so the copies can share the variable's buffer.
         auto argCopy =
             builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(valueType), constOne());
-        copyValue(valueType, valueAddr, argCopy);
+        shareValue(valueType, valueAddr, argCopy);
 
         auto castedCopy = castIfNeeded(params[i], argCopy, valueType, variableSymbol->getType());
 
         params[i]->getSymbol()->value = builder->create<mlir::LLVM::AllocaOp>(
             loc, ptrTy(), getMLIRType(variableSymbol->getType()), constOne());
-        copyValue(variableSymbol->getType(), castedCopy, params[i]->getSymbol()->value);
+        shareValue(variableSymbol->getType(), castedCopy, params[i]->getSymbol()->value);
         mlirArgs.push_back(params[i]->getSymbol()->value);
 
         freeAllocatedMemory(variableSymbol->getType(), castedCopy);
@@ -247,7 +266,7 @@ std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCa
   for (size_t i = 0; i < ctx->getArgs().size(); ++i) {
     if (auto variableSymbol =
             std::dynamic_pointer_cast<symTable::VariableSymbol>(params[i]->getSymbol());
-        variableSymbol->getQualifier() == ast::Qualifier::Const) {
+        variableSymbol->getQualifier() == ast::Qualifier::Const && !passedByReference[i]) {
       freeAllocatedMemory(variableSymbol->getType(), params[i]->getSymbol()->value);
     }
   }
@@ -266,4 +285,88 @@ std::any Backend::visitFuncProcCall(std::shared_ptr<ast::expressions::FuncProcCa
   return {};
 }
 
+std::shared_ptr<ast::statements::ReturnAst>
+Backend::getInlinableReturn(const std::shared_ptr<symTable::MethodSymbol> &methodSym) const {
+  if (!methodSym || methodSym->getScopeType() != symTable::ScopeType::Function ||
+      !isScalarType(methodSym->getReturnType())) {
+    return nullptr;
+  }
+  const auto function =
+      std::dynamic_pointer_cast<ast::prototypes::FunctionAst>(methodSym->getDef());
+  if (!function) {
+    return nullptr;
+  }
+  // `= expr;` functions are built as a block holding a single return, so they match here too
+  const auto body = std::dynamic_pointer_cast<ast::statements::BlockAst>(function->getBody());
+  if (!body || body->getChildren().size() != 1) {
+    return nullptr;
+  }
+  auto returnAst = std::dynamic_pointer_cast<ast::statements::ReturnAst>(body->getChildren()[0]);
+  if (!returnAst || !returnAst->getExpr()) {
+    return nullptr;
+  }
+  for (const auto &param : function->getProto()->getParams()) {
+    const auto paramSym = std::dynamic_pointer_cast<symTable::VariableSymbol>(param->getSymbol());
+    if (!paramSym || !isScalarType(paramSym->getType())) {
+      return nullptr;
+    }
+  }
+  return returnAst;
+}
+
+bool Backend::emitInlinedCall(std::shared_ptr<ast::expressions::FuncProcCallAst> ctx,
+                              const std::shared_ptr<symTable::MethodSymbol> &methodSym) {
+  const auto returnAst = getInlinableReturn(methodSym);
+  if (!returnAst) {
+    return false;
+  }
+  // The callee's scopes are in use while its own body or an enclosing inlined copy is emitted
+  const auto enclosingMethod = std::dynamic_pointer_cast<symTable::MethodSymbol>(
+      ast::walkers::ValidationWalker::getEnclosingFuncProcScope(ctx->getScope()));
+  if (enclosingMethod == methodSym ||
+      std::find(inlineStack.begin(), inlineStack.end(), methodSym.get()) != inlineStack.end()) {
+    return false;
+  }
+
+  const auto function =
+      std::dynamic_pointer_cast<ast::prototypes::FunctionAst>(methodSym->getDef());
+  const auto &params = function->getProto()->getParams();
+  const auto &args = ctx->getArgs();
+
+  // Params are const scalars, so each one can read the argument value directly instead of a copy
+  std::unordered_map<std::string, mlir::Value> paramValues;
+  for (size_t i = 0; i < args.size(); ++i) {
+    visit(args[i]);
+    auto [valueType, valueAddr] = popElementFromStack(args[i]);
+    const auto paramNode = std::dynamic_pointer_cast<ast::prototypes::FunctionParamAst>(params[i]);
+    const auto paramSym =
+        std::dynamic_pointer_cast<symTable::VariableSymbol>(params[i]->getSymbol());
+    if (valueType->getName() != paramSym->getType()->getName()) {
+      // Casts happen in place and the argument may be a caller variable, so cast a copy
+      auto argCopy =
+          builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(valueType), constOne());
+      copyValue(valueType, valueAddr, argCopy);
+      valueAddr = castIfNeeded(params[i], argCopy, valueType, paramSym->getType());
+    }
+    paramValues[paramNode->getName()] = valueAddr;
+  }
+
+  // The body only sees its own params, exactly as in the out-of-line function
+  auto callerBlockArg = std::move(blockArg);
+  blockArg = std::move(paramValues);
+  inlineStack.push_back(methodSym.get());
+
+  visit(returnAst->getExpr());
+  auto [returnType, returnAddr] = popElementFromStack(returnAst->getExpr());
+  returnAddr = castIfNeeded(returnAst, returnAddr, returnType, methodSym->getReturnType());
+  freeElementsFromMemory(returnAst);
+
+  inlineStack.pop_back();
+  blockArg = std::move(callerBlockArg);
+
+  ctx->getSymbol()->value = returnAddr;
+  pushElementToScopeStack(ctx, methodSym->getReturnType(), returnAddr);
+  return true;
+}
+
 } // namespace gazprea::backend
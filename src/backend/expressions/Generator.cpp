@@ -3,6 +3,46 @@
 
 namespace gazprea::backend {
 
+// Generator domains are integer arrays. Ranges are not materialized: rangeStart is set instead of
+// dataPtr and elements are computed from the index. Strides fill `stride` and read their operand.
+void Backend::emitGeneratorDomain(
+    const std::shared_ptr<ast::expressions::DomainExprAst> &domainExpr, mlir::Value &size,
+    mlir::Value &dataPtr, mlir::Value &rangeStart, StrideDomain &stride) {
+  if (auto range = getRangeDomain(domainExpr)) {
+    std::tie(rangeStart, size) = emitRangeBounds(range);
+    return;
+  }
+  if (auto strideExpr = getStrideDomain(domainExpr)) {
+    // Generator expressions cannot assign to the operand, so it needs no snapshot
+    stride = emitStrideDomain(strideExpr, /*snapshot=*/false);
+    size = stride.count;
+    dataPtr = stride.dataPtr;
+    return;
+  }
+  visit(domainExpr);
+  auto [domainType, domainArrayAddr] = popElementFromStack(domainExpr->getDomainExpression());
+
+  auto domainArrayType = getMLIRType(domainType);
+  auto domainSizeAddr = getArraySizeAddr(*builder, loc, domainArrayType, domainArrayAddr);
+  size = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domainSizeAddr);
+  auto domainDataPtrAddr = getArrayDataAddr(*builder, loc, domainArrayType, domainArrayAddr);
+  dataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domainDataPtrAddr);
+}
+
+mlir::Value Backend::generatorDomainElement(mlir::OpBuilder &b, mlir::Location l,
+                                            mlir::Value dataPtr, mlir::Value rangeStart,
+                                            mlir::Value step, mlir::Value idx) {
+  if (rangeStart) {
+    return b.create<mlir::LLVM::AddOp>(l, rangeStart, idx);
+  }
+  if (step) {
+    idx = b.create<mlir::LLVM::MulOp>(l, idx, step);
+  }
+  auto elementPtr =
+      b.create<mlir::LLVM::GEPOp>(l, ptrTy(), intTy(), dataPtr, mlir::ValueRange{idx});
+  return b.create<mlir::LLVM::LoadOp>(l, intTy(), elementPtr);
+}
+
 std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst> ctx) {
 
   auto generatorType = ctx->getInferredSymbolType();
@@ -11,14 +51,9 @@ std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst>
   if (dimensions == 1) {
     auto domainExpr = ctx->getDomainExprs()[0];
 
-    visit(domainExpr);
-    auto [domainType, domainArrayAddr] = popElementFromStack(domainExpr->getDomainExpression());
-
-    auto domainArrayType = getMLIRType(domainType);
-    auto domainSizeAddr = getArraySizeAddr(*builder, loc, domainArrayType, domainArrayAddr);
-    auto domainSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domainSizeAddr);
-    auto domainDataPtrAddr = getArrayDataAddr(*builder, loc, domainArrayType, domainArrayAddr);
-    auto domainDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domainDataPtrAddr);
+    mlir::Value domainSize, domainDataPtr, rangeStart;
+    StrideDomain stride;
+    emitGeneratorDomain(domainExpr, domainSize, domainDataPtr, rangeStart, stride);
 
     auto arrayTypeSymbol = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(generatorType);
     auto elementType = arrayTypeSymbol->getType();
@@ -40,9 +75,8 @@ std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst>
     builder->create<mlir::scf::ForOp>(
         loc, constZero(), domainSize, constOne(), mlir::ValueRange{},
         [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value loopIdx, mlir::ValueRange iterArgs) {
-          auto domainElementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), intTy(), domainDataPtr,
-                                                              mlir::ValueRange{loopIdx});
-          auto domainElementValue = b.create<mlir::LLVM::LoadOp>(l, intTy(), domainElementPtr);
+          auto domainElementValue =
+              generatorDomainElement(b, l, domainDataPtr, rangeStart, stride.step, loopIdx);
           auto iteratorAddr = b.create<mlir::LLVM::AllocaOp>(l, ptrTy(), intTy(), constOne(), 0);
           b.create<mlir::LLVM::StoreOp>(l, domainElementValue, iteratorAddr);
           blockArg[iteratorName] = iteratorAddr;
@@ -62,31 +96,22 @@ std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst>
           b.create<mlir::scf::YieldOp>(l);
         });
 
+    if (stride.addr)
+      freeAllocatedMemory(stride.type, stride.addr);
     pushElementToScopeStack(ctx, generatorType, resultArrayAddr);
 
   } else if (dimensions == 2) {
     auto domainExpr1 = ctx->getDomainExprs()[0];
     auto domainExpr2 = ctx->getDomainExprs()[1];
-    visit(domainExpr1);
-    auto [domain1Type, domain1ArrayAddr] = popElementFromStack(domainExpr1->getDomainExpression());
-
-    auto domain1ArrayType = getMLIRType(domain1Type);
-    auto domain1SizeAddr = getArraySizeAddr(*builder, loc, domain1ArrayType, domain1ArrayAddr);
-    auto domain1Size = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domain1SizeAddr);
-    auto domain1DataPtrAddr = getArrayDataAddr(*builder, loc, domain1ArrayType, domain1ArrayAddr);
-    auto domain1DataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domain1DataPtrAddr);
-
-    visit(domainExpr2);
-    auto [domain2Type, domain2ArrayAddr] = popElementFromStack(domainExpr2->getDomainExpression());
-
-    auto domain2ArrayType = getMLIRType(domain2Type);
-    auto domain2SizeAddr = getArraySizeAddr(*builder, loc, domain2ArrayType, domain2ArrayAddr);
-    auto domain2Size = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domain2SizeAddr);
-    auto domain2DataPtrAddr = getArrayDataAddr(*builder, loc, domain2ArrayType, domain2ArrayAddr);
-    auto domain2DataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domain2DataPtrAddr);
+    mlir::Value domain1Size, domain1DataPtr, range1Start;
+    StrideDomain stride1;
+    emitGeneratorDomain(domainExpr1, domain1Size, domain1DataPtr, range1Start, stride1);
+    mlir::Value domain2Size, domain2DataPtr, range2Start;
+    StrideDomain stride2;
+    emitGeneratorDomain(domainExpr2, domain2Size, domain2DataPtr, range2Start, stride2);
+
     auto arrayTypeSymbol = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(generatorType);
     auto innerArrayType = arrayTypeSymbol->getType(); // array<element_type>
-    auto innerArrayMLIRType = getMLIRType(innerArrayType);
     auto innerArrayTypeSymbol =
         std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(innerArrayType);
     auto elementType = innerArrayTypeSymbol->getType();
@@ -96,7 +121,9 @@ std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst>
         builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), outerStructType, constOne(), 0);
     auto outerSizeAddr = getArraySizeAddr(*builder, loc, outerStructType, resultArrayAddr);
     builder->create<mlir::LLVM::StoreOp>(loc, domain1Size, outerSizeAddr);
-    auto outerDataPtr = mallocArray(innerArrayMLIRType, domain1Size);
+    // Rows are laid out densely in one block, the runtime initializes their headers
+    auto outerDataPtr = mallocMatrix(elementMLIRType, domain1Size, domain2Size);
+    auto elements = getMatrixElements(*builder, loc, outerDataPtr, domain1Size);
     auto outerDataPtrAddr = getArrayDataAddr(*builder, loc, outerStructType, resultArrayAddr);
     builder->create<mlir::LLVM::StoreOp>(loc, outerDataPtr, outerDataPtrAddr);
 
@@ -109,34 +136,23 @@ std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst>
     builder->create<mlir::scf::ForOp>(
         loc, constZero(), domain1Size, constOne(), mlir::ValueRange{},
         [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value outerIdx, mlir::ValueRange iterArgs) {
-          auto domain1ElementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), intTy(), domain1DataPtr,
-                                                               mlir::ValueRange{outerIdx});
-          auto domain1ElementValue = b.create<mlir::LLVM::LoadOp>(l, intTy(), domain1ElementPtr);
+          auto domain1ElementValue =
+              generatorDomainElement(b, l, domain1DataPtr, range1Start, stride1.step, outerIdx);
           auto iterator1Addr = b.create<mlir::LLVM::AllocaOp>(l, ptrTy(), intTy(), constOne(), 0);
           b.create<mlir::LLVM::StoreOp>(l, domain1ElementValue, iterator1Addr);
           blockArg[iterator1Name] = iterator1Addr;
 
-          auto innerArrayStructPtr = b.create<mlir::LLVM::GEPOp>(
-              l, ptrTy(), innerArrayMLIRType, outerDataPtr, mlir::ValueRange{outerIdx});
-
-          auto innerSizeAddr = getArraySizeAddr(b, l, innerArrayMLIRType, innerArrayStructPtr);
-          b.create<mlir::LLVM::StoreOp>(l, domain2Size, innerSizeAddr);
-
-          auto innerDataPtr = mallocArray(elementMLIRType, domain2Size);
-          auto innerDataPtrAddr = getArrayDataAddr(b, l, innerArrayMLIRType, innerArrayStructPtr);
-          b.create<mlir::LLVM::StoreOp>(l, innerDataPtr, innerDataPtrAddr);
-
-          auto innerIs2DAddr = get2DArrayBoolAddr(b, l, innerArrayMLIRType, innerArrayStructPtr);
-          b.create<mlir::LLVM::StoreOp>(l, constFalse(), innerIs2DAddr);
+          auto rowStart = b.create<mlir::LLVM::MulOp>(l, outerIdx, domain2Size);
+          auto innerDataPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, elements,
+                                                          mlir::ValueRange{rowStart});
 
           b.create<mlir::scf::ForOp>(
               l, constZero(), domain2Size, constOne(), mlir::ValueRange{},
               [&](mlir::OpBuilder &b2, mlir::Location l2, mlir::Value innerIdx,
                   mlir::ValueRange iterArgs2) {
-                auto domain2ElementPtr = b2.create<mlir::LLVM::GEPOp>(
-                    l2, ptrTy(), intTy(), domain2DataPtr, mlir::ValueRange{innerIdx});
                 auto domain2ElementValue =
-                    b2.create<mlir::LLVM::LoadOp>(l2, intTy(), domain2ElementPtr);
+                    generatorDomainElement(b2, l2, domain2DataPtr, range2Start, stride2.step,
+                                           innerIdx);
 
                 auto iterator2Addr =
                     b2.create<mlir::LLVM::AllocaOp>(l2, ptrTy(), intTy(), constOne(), 0);
@@ -159,6 +175,10 @@ std::any Backend::visitGenerator(std::shared_ptr<ast::expressions::GeneratorAst>
           b.create<mlir::scf::YieldOp>(l);
         });
 
+    if (stride1.addr)
+      freeAllocatedMemory(stride1.type, stride1.addr);
+    if (stride2.addr)
+      freeAllocatedMemory(stride2.type, stride2.addr);
     pushElementToScopeStack(ctx, generatorType, resultArrayAddr);
   }
 
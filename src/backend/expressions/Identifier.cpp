@@ -13,7 +13,7 @@ std::any Backend::visitIdentifier(std::shared_ptr<ast::expressions::IdentifierAs
     if (variableSymbol->getQualifier() == ast::Qualifier::Const) {
       auto newAddr = builder->create<mlir::LLVM::AllocaOp>(
           loc, ptrTy(), getMLIRType(variableSymType), constOne());
-      copyValue(variableSymType, iteratorAddr, newAddr);
+      shareValue(variableSymType, iteratorAddr, newAddr);
       pushElementToScopeStack(ctx, variableSymType, newAddr);
       return {};
     }
@@ -40,9 +40,10 @@ std::any Backend::visitIdentifier(std::shared_ptr<ast::expressions::IdentifierAs
       std::dynamic_pointer_cast<symTable::VariableSymbol>(ctx->getSymbol())->getType();
 
   if (not ctx->isLValue()) {
+    // A const can never be written, so the copy shares its buffer until the copy itself is
     auto newAddr = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(variableSymType),
                                                          constOne());
-    copyValue(variableSymType, valueAddr, newAddr);
+    shareValue(variableSymType, valueAddr, newAddr);
     pushElementToScopeStack(ctx, variableSymType, newAddr);
   } else {
     pushElementToScopeStack(ctx, ctx->getInferredSymbolType(), valueAddr);
@@ -3,27 +3,41 @@
 
 namespace gazprea::backend {
 
-std::any Backend::visitRange(std::shared_ptr<ast::expressions::RangeAst> ctx) {
-  visit(ctx->getStart());
-  auto [startType, startAddr] = popElementFromStack(ctx->getStart());
+std::shared_ptr<ast::expressions::RangeAst>
+Backend::getRangeDomain(const std::shared_ptr<ast::expressions::DomainExprAst> &domainExpr) const {
+  return std::dynamic_pointer_cast<ast::expressions::RangeAst>(domainExpr->getDomainExpression());
+}
+
+// Evaluates the range bounds once and returns {start, end - start + 1}. A negative count means an
+// empty range.
+std::pair<mlir::Value, mlir::Value>
+Backend::emitRangeBounds(const std::shared_ptr<ast::expressions::RangeAst> &range) {
+  visit(range->getStart());
+  auto [startType, startAddr] = popElementFromStack(range->getStart());
   if (startType->getName() != "integer") {
-    throw TypeError(ctx->getLineNumber(),
+    throw TypeError(range->getLineNumber(),
                     "Range start expression must be of type integer, got " + startType->getName());
   }
 
   auto startValue = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), startAddr);
 
-  visit(ctx->getEnd());
-  auto [endType, endAddr] = popElementFromStack(ctx->getEnd());
+  visit(range->getEnd());
+  auto [endType, endAddr] = popElementFromStack(range->getEnd());
   if (endType->getName() != "integer") {
-    throw TypeError(ctx->getLineNumber(),
+    throw TypeError(range->getLineNumber(),
                     "Range end expression must be of type integer, got " + endType->getName());
   }
 
   auto endValue = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), endAddr);
 
   auto diff = builder->create<mlir::arith::SubIOp>(loc, endValue, startValue);
-  auto arraySize = builder->create<mlir::arith::AddIOp>(loc, diff, constOne());
+  auto count = builder->create<mlir::arith::AddIOp>(loc, diff, constOne());
+  return {startValue, count};
+}
+
+std::any Backend::visitRange(std::shared_ptr<ast::expressions::RangeAst> ctx) {
+  mlir::Value startValue, arraySize;
+  std::tie(startValue, arraySize) = emitRangeBounds(ctx);
 
   auto arrayStructType = structTy({intTy(), ptrTy(), boolTy()});
   auto arrayStructAddr =
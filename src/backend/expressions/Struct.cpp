@@ -21,7 +21,7 @@ std::any Backend::visitStruct(std::shared_ptr<ast::expressions::StructLiteralAst
     elementValueAddr =
         castIfNeeded(ctx, elementValueAddr, ctx->getElements()[i]->getInferredSymbolType(),
                      structTypeSymbol->getResolvedTypes()[i]);
-    copyValue(structTypeSymbol->getResolvedTypes()[i], elementValueAddr, elementPtr);
+    shareValue(structTypeSymbol->getResolvedTypes()[i], elementValueAddr, elementPtr);
     freeAllocatedMemory(structTypeSymbol->getResolvedTypes()[i], elementValueAddr);
   }
   pushElementToScopeStack(ctx, ctx->getInferredSymbolType(), structAddr);
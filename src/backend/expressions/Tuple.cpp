@@ -22,7 +22,7 @@ std::any Backend::visitTuple(std::shared_ptr<ast::expressions::TupleLiteralAst>
     elementValueAddr =
         castIfNeeded(ctx, elementValueAddr, ctx->getElements()[i]->getInferredSymbolType(),
                      tupleTypeSymbol->getResolvedTypes()[i]);
-    copyValue(tupleTypeSymbol->getResolvedTypes()[i], elementValueAddr, elementPtr);
+    shareValue(tupleTypeSymbol->getResolvedTypes()[i], elementValueAddr, elementPtr);
     freeAllocatedMemory(tupleTypeSymbol->getResolvedTypes()[i], elementValueAddr);
   }
 
@@ -3,6 +3,9 @@
 namespace gazprea::backend {
 
 std::any Backend::visitUnary(std::shared_ptr<ast::expressions::UnaryAst> ctx) {
+  if (tryEmitFusedExpression(ctx)) {
+    return {};
+  }
   visit(ctx->getExpression());
   auto [type, valueAddr] = popElementFromStack(ctx->getExpression());
   auto op = ctx->getUnaryOpType();
@@ -323,23 +323,12 @@ void Backend::makeReverseBuiltin() {
               auto destBase = b2.create<mlir::LLVM::MulOp>(l2, intTy(), idx, elemSizeArg);
               auto srcBase = b2.create<mlir::LLVM::MulOp>(l2, intTy(), reverseIdx, elemSizeArg);
 
-              b2.create<mlir::scf::ForOp>(
-                  l2, zero, elemSizeArg, one, mlir::ValueRange{},
-                  [&](mlir::OpBuilder &b3, mlir::Location l3, mlir::Value byteIdx,
-                      mlir::ValueRange /*iterArgs*/) {
-                    auto destByteIndex =
-                        b3.create<mlir::LLVM::AddOp>(l3, intTy(), destBase, byteIdx);
-                    auto srcByteIndex = b3.create<mlir::LLVM::AddOp>(l3, intTy(), srcBase, byteIdx);
-
-                    auto destPtr = b3.create<mlir::LLVM::GEPOp>(l3, ptrTy(), byteTy, newDataPtr,
-                                                                mlir::ValueRange{destByteIndex});
-                    auto srcPtr = b3.create<mlir::LLVM::GEPOp>(l3, ptrTy(), byteTy, dataPtrArg,
-                                                               mlir::ValueRange{srcByteIndex});
-
-                    auto byteValue = b3.create<mlir::LLVM::LoadOp>(l3, byteTy, srcPtr);
-                    b3.create<mlir::LLVM::StoreOp>(l3, byteValue, destPtr);
-                    b3.create<mlir::scf::YieldOp>(l3);
-                  });
+              auto destPtr = b2.create<mlir::LLVM::GEPOp>(l2, ptrTy(), byteTy, newDataPtr,
+                                                          mlir::ValueRange{destBase});
+              auto srcPtr = b2.create<mlir::LLVM::GEPOp>(l2, ptrTy(), byteTy, dataPtrArg,
+                                                         mlir::ValueRange{srcBase});
+              b2.create<mlir::LLVM::MemcpyOp>(l2, destPtr, srcPtr, elemSizeI64,
+                                              /*isVolatile=*/false);
               b2.create<mlir::scf::YieldOp>(l2);
             });
 
@@ -438,6 +427,9 @@ Backend::visitReverseBuiltinFunc(std::shared_ptr<ast::expressions::ReverseBuilti
   const bool isElemVector = elemTypeName.rfind("vector", 0) == 0;
 
   if (isElemArray || isElemVector) {
+    auto innerElementMLIRType = getMLIRType(
+        isElemArray ? std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(elementType)->getType()
+                    : std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(elementType)->getType());
     auto zero = constZero();
     auto one = constOne();
     auto idx32Ty = builder->getI32Type();
@@ -457,19 +449,8 @@ Backend::visitReverseBuiltinFunc(std::shared_ptr<ast::expressions::ReverseBuilti
               l, ptrTy(), elementMLIRType, elemStructPtr, mlir::ValueRange{zeroIdx, oneIdx});
           auto oldElemDataPtr = b.create<mlir::LLVM::LoadOp>(l, ptrTy(), elemDataPtrPtr);
 
-          auto newElemDataPtr = mallocArray(intTy(), elemSize);
-          auto i8Ty = b.getI8Type();
-          b.create<mlir::scf::ForOp>(
-              l, zero, elemSize, one, mlir::ValueRange{},
-              [&](mlir::OpBuilder &b2, mlir::Location l2, mlir::Value byteIdx, mlir::ValueRange) {
-                auto srcPtr = b2.create<mlir::LLVM::GEPOp>(l2, ptrTy(), i8Ty, oldElemDataPtr,
-                                                           mlir::ValueRange{byteIdx});
-                auto destPtr = b2.create<mlir::LLVM::GEPOp>(l2, ptrTy(), i8Ty, newElemDataPtr,
-                                                            mlir::ValueRange{byteIdx});
-                auto byteVal = b2.create<mlir::LLVM::LoadOp>(l2, i8Ty, srcPtr);
-                b2.create<mlir::LLVM::StoreOp>(l2, byteVal, destPtr);
-                b2.create<mlir::scf::YieldOp>(l2);
-              });
+          auto newElemDataPtr = mallocArray(innerElementMLIRType, elemSize);
+          copyElements(b, l, newElemDataPtr, oldElemDataPtr, innerElementMLIRType, elemSize);
           b.create<mlir::LLVM::StoreOp>(l, newElemDataPtr, elemDataPtrPtr);
           b.create<mlir::scf::YieldOp>(l);
         });
@@ -580,19 +561,7 @@ Backend::visitFormatBuiltinFunc(std::shared_ptr<ast::expressions::FormatBuiltinF
     auto resultLength = length.getResult();
     auto resultData = mallocArray(byteTy, resultLength);
 
-    auto zero = constZero();
-    auto one = constOne();
-    builder->create<mlir::scf::ForOp>(
-        loc, zero, resultLength, one, mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange) {
-          auto srcPtr =
-              b.create<mlir::LLVM::GEPOp>(l, ptrTy(), byteTy, buffer, mlir::ValueRange{i});
-          auto dstPtr =
-              b.create<mlir::LLVM::GEPOp>(l, ptrTy(), byteTy, resultData, mlir::ValueRange{i});
-          auto byteVal = b.create<mlir::LLVM::LoadOp>(l, byteTy, srcPtr);
-          b.create<mlir::LLVM::StoreOp>(l, byteVal, dstPtr);
-          b.create<mlir::scf::YieldOp>(l);
-        });
+    copyElements(*builder, loc, resultData, buffer, byteTy, resultLength);
 
     auto freeFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kFreeName);
     if (!freeFunc) {
@@ -642,19 +611,7 @@ Backend::visitFormatBuiltinFunc(std::shared_ptr<ast::expressions::FormatBuiltinF
     auto resultLength = length.getResult();
     auto resultData = mallocArray(byteTy, resultLength);
 
-    auto zero = constZero();
-    auto one = constOne();
-    builder->create<mlir::scf::ForOp>(
-        loc, zero, resultLength, one, mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange) {
-          auto srcPtr =
-              b.create<mlir::LLVM::GEPOp>(l, ptrTy(), byteTy, buffer, mlir::ValueRange{i});
-          auto dstPtr =
-              b.create<mlir::LLVM::GEPOp>(l, ptrTy(), byteTy, resultData, mlir::ValueRange{i});
-          auto byteVal = b.create<mlir::LLVM::LoadOp>(l, byteTy, srcPtr);
-          b.create<mlir::LLVM::StoreOp>(l, byteVal, dstPtr);
-          b.create<mlir::scf::YieldOp>(l);
-        });
+    copyElements(*builder, loc, resultData, buffer, byteTy, resultLength);
 
     auto freeFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kFreeName);
     if (!freeFunc) {
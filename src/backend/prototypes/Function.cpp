@@ -3,6 +3,8 @@
 #include "symTable/ArrayTypeSymbol.h"
 #include "symTable/MethodSymbol.h"
 
+#include <algorithm>
+
 namespace gazprea::backend {
 
 std::any Backend::visitFunction(std::shared_ptr<ast::prototypes::FunctionAst> ctx) {
@@ -35,13 +37,155 @@ std::any Backend::visitFunction(std::shared_ptr<ast::prototypes::FunctionAst> ct
     currentFunctionProto = ctx->getProto();
 
     visit(ctx->getProto());
+    beginTailCallLoop(ctx->getProto(), ctx->getBody());
     visit(ctx->getBody());
+    tailCallLoop.reset();
 
     // Clear after function body
     currentFunctionProto = nullptr;
   }
   builder->restoreInsertionPoint(savedInsertPoint);
+  if (!isForwardDecl && memoizeFunctions &&
+      isMemoizable(funcOp, methodSym, ctx->getProto()->getParams())) {
+    emitMemoizedWrapper(funcOp, methodSym, ctx->getProto()->getParams());
+    builder->restoreInsertionPoint(savedInsertPoint);
+  }
   return {};
 }
 
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateMemoLookupFunc() {
+  auto lookupFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kMemoLookupName);
+  if (lookupFunc) {
+    return lookupFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: bool memoLookup(ptr table, ptr key, ptr result); C bool comes back as i8
+  auto lookupFnType = mlir::LLVM::LLVMFunctionType::get(charTy(), {ptrTy(), ptrTy(), ptrTy()},
+                                                        /*isVarArg=*/false);
+  lookupFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kMemoLookupName, lookupFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return lookupFunc;
+}
+
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateMemoStoreFunc() {
+  auto storeFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kMemoStoreName);
+  if (storeFunc) {
+    return storeFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: void memoStore(ptr table, ptr key, i32 keyLength, i64 result)
+  auto storeFnType = mlir::LLVM::LLVMFunctionType::get(
+      mlir::LLVM::LLVMVoidType::get(builder->getContext()),
+      {ptrTy(), ptrTy(), intTy(), builder->getI64Type()}, /*isVarArg=*/false);
+  storeFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kMemoStoreName, storeFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return storeFunc;
+}
+
+bool Backend::isMemoizable(mlir::LLVM::LLVMFuncOp funcOp,
+                           std::shared_ptr<symTable::MethodSymbol> methodSym,
+                           const std::vector<std::shared_ptr<ast::Ast>> &params) const {
+  if (!isScalarType(methodSym->getReturnType())) {
+    return false;
+  }
+  for (const auto &param : params) {
+    const auto paramSym = std::dynamic_pointer_cast<symTable::VariableSymbol>(param->getSymbol());
+    if (!paramSym || !isScalarType(paramSym->getType())) {
+      return false;
+    }
+  }
+  // Only recursive functions repeat work worth caching; everything else would just pay for lookups
+  bool isSelfRecursive = false;
+  funcOp.walk([&](mlir::LLVM::CallOp call) {
+    if (call.getCallee() && *call.getCallee() == methodSym->getName()) {
+      isSelfRecursive = true;
+    }
+  });
+  return isSelfRecursive;
+}
+
+void Backend::emitMemoizedWrapper(mlir::LLVM::LLVMFuncOp funcOp,
+                                  std::shared_ptr<symTable::MethodSymbol> methodSym,
+                                  const std::vector<std::shared_ptr<ast::Ast>> &params) {
+  // The emitted body moves aside and a wrapper takes over its name, so every call (including the
+  // recursive ones already emitted in the body) goes through the cache. Results are kept for the
+  // rest of the run, which is sound because functions are pure.
+  const auto name = methodSym->getName();
+  const auto implName = name + "_memo_impl";
+  const auto tableName = name + "_memo_table";
+  funcOp.setSymName(implName);
+  funcOp.setLinkage(mlir::LLVM::Linkage::Internal);
+
+  auto i64Ty = builder->getI64Type();
+  auto widen = [&](mlir::Value value) -> mlir::Value {
+    if (value.getType() == floatTy()) {
+      value = builder->create<mlir::LLVM::BitcastOp>(loc, intTy(), value);
+    }
+    return builder->create<mlir::LLVM::ZExtOp>(loc, i64Ty, value);
+  };
+  auto narrow = [&](mlir::Value value, mlir::Type type) -> mlir::Value {
+    if (type == floatTy()) {
+      auto bits = builder->create<mlir::LLVM::TruncOp>(loc, intTy(), value);
+      return builder->create<mlir::LLVM::BitcastOp>(loc, floatTy(), bits);
+    }
+    return builder->create<mlir::LLVM::TruncOp>(loc, type, value);
+  };
+
+  // The table pointer starts out null; memoStore allocates it on the first miss
+  auto tableGlobal = builder->create<mlir::LLVM::GlobalOp>(
+      loc, ptrTy(), /*isConstant=*/false, mlir::LLVM::Linkage::Internal, tableName,
+      mlir::Attribute(), /*alignment=*/0);
+  builder->setInsertionPointToStart(builder->createBlock(&tableGlobal.getInitializerRegion()));
+  auto nullTable = builder->create<mlir::LLVM::ZeroOp>(loc, ptrTy());
+  builder->create<mlir::LLVM::ReturnOp>(loc, nullTable.getResult());
+
+  builder->setInsertionPointAfter(tableGlobal);
+  const auto returnType = funcOp.getFunctionType().getReturnType();
+  auto wrapperOp = builder->create<mlir::LLVM::LLVMFuncOp>(loc, name, funcOp.getFunctionType());
+  mlir::Block *entry = wrapperOp.addEntryBlock();
+  auto *hitBlock = new mlir::Block();
+  auto *missBlock = new mlir::Block();
+  wrapperOp.getBody().push_back(hitBlock);
+  wrapperOp.getBody().push_back(missBlock);
+
+  // Key: every argument widened to an i64 slot
+  builder->setInsertionPointToStart(entry);
+  const int keyLength = static_cast<int>(params.size());
+  auto keyTy = mlir::LLVM::LLVMArrayType::get(i64Ty, std::max(keyLength, 1));
+  auto keyAddr = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), keyTy, constOne());
+  auto resultAddr = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), i64Ty, constOne());
+  for (int i = 0; i < keyLength; ++i) {
+    const auto paramSym =
+        std::dynamic_pointer_cast<symTable::VariableSymbol>(params[i]->getSymbol());
+    auto argValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(paramSym->getType()),
+                                                        entry->getArgument(i));
+    auto slotAddr = builder->create<mlir::LLVM::GEPOp>(
+        loc, ptrTy(), keyTy, keyAddr,
+        mlir::ValueRange{constZero(), builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), i)});
+    builder->create<mlir::LLVM::StoreOp>(loc, widen(argValue), slotAddr);
+  }
+  auto tableAddr = builder->create<mlir::LLVM::AddressOfOp>(loc, tableGlobal);
+  auto found = builder->create<mlir::LLVM::CallOp>(
+      loc, getOrCreateMemoLookupFunc(), mlir::ValueRange{tableAddr, keyAddr, resultAddr});
+  auto isHit = builder->create<mlir::LLVM::ICmpOp>(
+      loc, mlir::LLVM::ICmpPredicate::ne, found.getResult(),
+      builder->create<mlir::LLVM::ConstantOp>(loc, charTy(), 0));
+  builder->create<mlir::cf::CondBranchOp>(loc, isHit, hitBlock, missBlock);
+
+  builder->setInsertionPointToStart(hitBlock);
+  auto cached = builder->create<mlir::LLVM::LoadOp>(loc, i64Ty, resultAddr);
+  builder->create<mlir::LLVM::ReturnOp>(loc, narrow(cached, returnType));
+
+  builder->setInsertionPointToStart(missBlock);
+  auto computed = builder->create<mlir::LLVM::CallOp>(loc, funcOp, entry->getArguments());
+  builder->create<mlir::LLVM::CallOp>(
+      loc, getOrCreateMemoStoreFunc(),
+      mlir::ValueRange{tableAddr, keyAddr,
+                       builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), keyLength),
+                       widen(computed.getResult())});
+  builder->create<mlir::LLVM::ReturnOp>(loc, computed.getResult());
+}
+
 } // namespace gazprea::backend
@@ -81,26 +81,6 @@ std::any Backend::visitAppendMemberFunc(std::shared_ptr<ast::statements::AppendM
     builder->create<mlir::LLVM::StoreOp>(loc, boolTrue, is2DAddr);
   }
 
-  auto freeFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kFreeName);
-  if (!freeFunc) {
-    auto savedInsertionPoint = builder->saveInsertionPoint();
-    builder->setInsertionPointToStart(module.getBody());
-
-    auto voidType = mlir::LLVM::LLVMVoidType::get(builder->getContext());
-    auto freeFnType = mlir::LLVM::LLVMFunctionType::get(voidType, {ptrTy()}, false);
-    freeFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kFreeName, freeFnType);
-
-    builder->restoreInsertionPoint(savedInsertionPoint);
-  }
-
-  auto sizeAddr = gepOpVector(vectorStructType, vectorAddr, VectorOffset::Size);
-  auto capacityAddr = gepOpVector(vectorStructType, vectorAddr, VectorOffset::Capacity);
-  auto dataAddr = gepOpVector(vectorStructType, vectorAddr, VectorOffset::Data);
-
-  auto zeroConst = constZero();
-  auto oneConst = constOne();
-  auto twoConst = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 2);
-
   for (const auto &arg : ctx->getArgs()) {
     visit(arg);
     auto [argType, argAddr] = popElementFromStack(arg);
@@ -108,66 +88,7 @@ std::any Backend::visitAppendMemberFunc(std::shared_ptr<ast::statements::AppendM
       continue;
     }
 
-    auto currentSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), sizeAddr);
-    auto currentCapacity = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), capacityAddr);
-    auto newSize = builder->create<mlir::LLVM::AddOp>(loc, intTy(), currentSize, oneConst);
-
-    auto oldDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr);
-
-    auto needsGrowth = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq,
-                                                           currentSize, currentCapacity);
-
-    auto growthIf = builder->create<mlir::scf::IfOp>(loc, mlir::TypeRange{ptrTy(), intTy()},
-                                                     needsGrowth, /*withElseRegion*/ true);
-    auto afterIfIp = builder->saveInsertionPoint();
-
-    builder->setInsertionPointToStart(&growthIf.getThenRegion().front());
-    auto isZeroCapacity = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq,
-                                                              currentCapacity, zeroConst);
-    auto doubledCapacity =
-        builder->create<mlir::LLVM::MulOp>(loc, intTy(), currentCapacity, twoConst);
-    auto desiredCapacity =
-        builder->create<mlir::LLVM::SelectOp>(loc, isZeroCapacity, oneConst, doubledCapacity);
-    auto newDataPtr = mallocArray(elementMLIRType, desiredCapacity);
-
-    builder->create<mlir::scf::ForOp>(
-        loc, zeroConst, currentSize, oneConst, mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto srcPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, oldDataPtr,
-                                                    mlir::ValueRange{i});
-          auto destPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, newDataPtr,
-                                                     mlir::ValueRange{i});
-          auto elemValue = b.create<mlir::LLVM::LoadOp>(l, elementMLIRType, srcPtr);
-          b.create<mlir::LLVM::StoreOp>(l, elemValue, destPtr);
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
-
-    auto nullPtr = builder->create<mlir::LLVM::ZeroOp>(loc, ptrTy());
-    auto hasAlloc = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::ne,
-                                                        oldDataPtr, nullPtr);
-    builder->create<mlir::scf::IfOp>(
-        loc, hasAlloc,
-        [&](mlir::OpBuilder &b, mlir::Location l) {
-          b.create<mlir::LLVM::CallOp>(l, freeFunc, mlir::ValueRange{oldDataPtr});
-          b.create<mlir::scf::YieldOp>(l);
-        },
-        [&](mlir::OpBuilder &b, mlir::Location l) { b.create<mlir::scf::YieldOp>(l); });
-
-    builder->create<mlir::scf::YieldOp>(loc, mlir::ValueRange{newDataPtr, desiredCapacity});
-
-    builder->setInsertionPointToStart(&growthIf.getElseRegion().front());
-    builder->create<mlir::scf::YieldOp>(loc, mlir::ValueRange{oldDataPtr, currentCapacity});
-
-    builder->restoreInsertionPoint(afterIfIp);
-
-    auto ensuredDataPtr = growthIf.getResult(0);
-    auto ensuredCapacity = growthIf.getResult(1);
-
-    builder->create<mlir::LLVM::StoreOp>(loc, ensuredDataPtr, dataAddr);
-    builder->create<mlir::LLVM::StoreOp>(loc, ensuredCapacity, capacityAddr);
-
-    auto insertPtr = builder->create<mlir::LLVM::GEPOp>(
-        loc, ptrTy(), elementMLIRType, ensuredDataPtr, mlir::ValueRange{currentSize});
+    auto insertPtr = pushVectorSlots(vectorAddr, elementMLIRType, constOne());
     argAddr = castIfNeeded(ctx, argAddr, argType, elementType);
     if (isTypeArray(elementType) && isTypeArray(argType) &&
         !typesEquivalent(argType, elementType)) {
@@ -203,8 +124,6 @@ std::any Backend::visitAppendMemberFunc(std::shared_ptr<ast::statements::AppendM
         padArrayIfNeeded(insertPtr, elementType, targetOuterSize, targetInnerSize);
       }
     }
-
-    builder->create<mlir::LLVM::StoreOp>(loc, newSize, sizeAddr);
   }
 
   return {};
@@ -231,27 +150,6 @@ std::any Backend::visitPushMemberFunc(std::shared_ptr<ast::statements::PushMembe
     return {};
   }
 
-  auto freeFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kFreeName);
-  if (!freeFunc) {
-    auto savedInsertionPoint = builder->saveInsertionPoint();
-    builder->setInsertionPointToStart(module.getBody());
-
-    auto voidType = mlir::LLVM::LLVMVoidType::get(builder->getContext());
-    auto freeFnType = mlir::LLVM::LLVMFunctionType::get(voidType, {ptrTy()}, false);
-    freeFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kFreeName, freeFnType);
-
-    builder->restoreInsertionPoint(savedInsertionPoint);
-  }
-
-  auto vectorStructType = getMLIRType(vectorTypeSym);
-  auto sizeAddr = gepOpVector(vectorStructType, vectorAddr, VectorOffset::Size);
-  auto capacityAddr = gepOpVector(vectorStructType, vectorAddr, VectorOffset::Capacity);
-  auto dataAddr = gepOpVector(vectorStructType, vectorAddr, VectorOffset::Data);
-
-  auto zeroConst = constZero();
-  auto oneConst = constOne();
-  auto twoConst = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 2);
-
   for (const auto &arg : ctx->getArgs()) {
     visit(arg);
     auto [argType, argAddr] = popElementFromStack(arg);
@@ -259,66 +157,7 @@ std::any Backend::visitPushMemberFunc(std::shared_ptr<ast::statements::PushMembe
       continue;
     }
 
-    auto currentSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), sizeAddr);
-    auto currentCapacity = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), capacityAddr);
-    auto newSize = builder->create<mlir::LLVM::AddOp>(loc, intTy(), currentSize, oneConst);
-
-    auto oldDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr);
-
-    auto needsGrowth = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq,
-                                                           currentSize, currentCapacity);
-
-    auto growthIf = builder->create<mlir::scf::IfOp>(loc, mlir::TypeRange{ptrTy(), intTy()},
-                                                     needsGrowth, /*withElseRegion*/ true);
-    auto afterIfIp = builder->saveInsertionPoint();
-
-    builder->setInsertionPointToStart(&growthIf.getThenRegion().front());
-    auto isZeroCapacity = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::eq,
-                                                              currentCapacity, zeroConst);
-    auto doubledCapacity =
-        builder->create<mlir::LLVM::MulOp>(loc, intTy(), currentCapacity, twoConst);
-    auto desiredCapacity =
-        builder->create<mlir::LLVM::SelectOp>(loc, isZeroCapacity, oneConst, doubledCapacity);
-    auto newDataPtr = mallocArray(elementMLIRType, desiredCapacity);
-
-    builder->create<mlir::scf::ForOp>(
-        loc, zeroConst, currentSize, oneConst, mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto srcPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, oldDataPtr,
-                                                    mlir::ValueRange{i});
-          auto destPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, newDataPtr,
-                                                     mlir::ValueRange{i});
-          auto elemValue = b.create<mlir::LLVM::LoadOp>(l, elementMLIRType, srcPtr);
-          b.create<mlir::LLVM::StoreOp>(l, elemValue, destPtr);
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
-
-    auto nullPtr = builder->create<mlir::LLVM::ZeroOp>(loc, ptrTy());
-    auto hasAlloc = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::ne,
-                                                        oldDataPtr, nullPtr);
-    builder->create<mlir::scf::IfOp>(
-        loc, hasAlloc,
-        [&](mlir::OpBuilder &b, mlir::Location l) {
-          b.create<mlir::LLVM::CallOp>(l, freeFunc, mlir::ValueRange{oldDataPtr});
-          b.create<mlir::scf::YieldOp>(l);
-        },
-        [&](mlir::OpBuilder &b, mlir::Location l) { b.create<mlir::scf::YieldOp>(l); });
-
-    builder->create<mlir::scf::YieldOp>(loc, mlir::ValueRange{newDataPtr, desiredCapacity});
-
-    builder->setInsertionPointToStart(&growthIf.getElseRegion().front());
-    builder->create<mlir::scf::YieldOp>(loc, mlir::ValueRange{oldDataPtr, currentCapacity});
-
-    builder->restoreInsertionPoint(afterIfIp);
-
-    auto ensuredDataPtr = growthIf.getResult(0);
-    auto ensuredCapacity = growthIf.getResult(1);
-
-    builder->create<mlir::LLVM::StoreOp>(loc, ensuredDataPtr, dataAddr);
-    builder->create<mlir::LLVM::StoreOp>(loc, ensuredCapacity, capacityAddr);
-
-    auto insertPtr = builder->create<mlir::LLVM::GEPOp>(
-        loc, ptrTy(), elementMLIRType, ensuredDataPtr, mlir::ValueRange{currentSize});
+    auto insertPtr = pushVectorSlots(vectorAddr, elementMLIRType, constOne());
     argAddr = castIfNeeded(ctx, argAddr, argType, elementType);
     copyValue(elementType, argAddr, insertPtr);
     freeAllocatedMemory(elementType, argAddr);
@@ -346,8 +185,6 @@ std::any Backend::visitPushMemberFunc(std::shared_ptr<ast::statements::PushMembe
         padArrayIfNeeded(insertPtr, elementType, targetOuterSize, targetInnerSize);
       }
     }
-
-    builder->create<mlir::LLVM::StoreOp>(loc, newSize, sizeAddr);
   }
 
   return {};
@@ -368,6 +205,12 @@ std::any Backend::visitConcatMemberFunc(std::shared_ptr<ast::statements::ConcatM
     return {};
   }
 
+  const auto elementType = vectorTypeSym->getType();
+  auto elementMLIRType = getMLIRType(elementType);
+  if (!elementMLIRType) {
+    return {};
+  }
+
   for (const auto &arg : ctx->getArgs()) {
     visit(arg);
     auto [argType, argAddr] = popElementFromStack(arg);
@@ -375,8 +218,26 @@ std::any Backend::visitConcatMemberFunc(std::shared_ptr<ast::statements::ConcatM
       continue;
     }
 
-    auto resultAddr = concatVectors(vectorType, vectorAddr, argAddr);
-    copyValue(vectorType, resultAddr, vectorAddr);
+    mlir::Value argSize =
+        builder->create<mlir::LLVM::LoadOp>(loc, intTy(), getContainerSizeAddr(argType, argAddr));
+    auto destPtr = pushVectorSlots(vectorAddr, elementMLIRType, argSize);
+    // Loaded after growing so that `v.concat(v)` reads the current buffer
+    mlir::Value argDataPtr =
+        builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), getContainerDataAddr(argType, argAddr));
+    if (isTypeArray(elementType) || isTypeVector(elementType)) {
+      builder->create<mlir::scf::ForOp>(
+          loc, constZero(), argSize, constOne(), mlir::ValueRange{},
+          [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
+            auto srcPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, argDataPtr,
+                                                      mlir::ValueRange{i});
+            auto dstPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, destPtr,
+                                                      mlir::ValueRange{i});
+            copyValue(elementType, srcPtr, dstPtr);
+            b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
+          });
+    } else {
+      copyElements(*builder, loc, destPtr, argDataPtr, elementMLIRType, argSize);
+    }
     freeAllocatedMemory(argType, argAddr);
   }
 
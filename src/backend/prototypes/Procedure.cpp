@@ -70,7 +70,9 @@ std::any Backend::visitProcedure(std::shared_ptr<ast::prototypes::ProcedureAst>
       currentFunctionProto = ctx->getProto();
 
       visit(ctx->getProto());
+      beginTailCallLoop(ctx->getProto(), ctx->getBody());
       visit(ctx->getBody());
+      tailCallLoop.reset();
 
       // Clear after procedure body
       currentFunctionProto = nullptr;
@@ -13,6 +13,8 @@ Backend::visitArrayElementAssign(std::shared_ptr<ast::statements::ArrayElementAs
       static_cast<bool>(std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(leftInstanceType));
 
   visit(ctx->getElementIndex());
+  // The buffer may be shared with copies of the collection, which must not see the write
+  makeBufferUnique(leftInstanceType, ctx->getArrayInstance()->getEvaluatedAddr());
   if (ctx->getElementIndex()->getNodeType() == ast::NodeType::SingularIndexExpr) {
     auto [indexType, indexAddr] = popElementFromStack(ctx->getElementIndex());
     mlir::Value collectionSize;
@@ -33,7 +33,7 @@ std::any Backend::visitAssignment(std::shared_ptr<ast::statements::AssignmentAst
 
       const auto fromType = tupleTypeSymbol->getResolvedTypes()[i];
       const auto castedPtr = castIfNeeded(ctx, elementPtr, fromType, lVal->getAssignSymbolType());
-      copyValue(lVal->getAssignSymbolType(), castedPtr, destinationPtr);
+      shareValue(lVal->getAssignSymbolType(), castedPtr, destinationPtr);
       freeAllocatedMemory(lVal->getAssignSymbolType(), castedPtr);
     }
   } else if (auto tupleElementAssign =
@@ -45,7 +45,7 @@ std::any Backend::visitAssignment(std::shared_ptr<ast::statements::AssignmentAst
 
     const auto fromType = ctx->getExpr()->getInferredSymbolType();
     valueAddr = castIfNeeded(ctx, valueAddr, fromType, tupleElementAssign->getAssignSymbolType());
-    copyValue(tupleElementAssign->getAssignSymbolType(), valueAddr, elementAddr);
+    shareValue(tupleElementAssign->getAssignSymbolType(), valueAddr, elementAddr);
     freeAllocatedMemory(tupleElementAssign->getAssignSymbolType(), valueAddr);
 
   } else if (const auto structElementAssign =
@@ -57,7 +57,7 @@ std::any Backend::visitAssignment(std::shared_ptr<ast::statements::AssignmentAst
 
     const auto fromType = ctx->getExpr()->getInferredSymbolType();
     valueAddr = castIfNeeded(ctx, valueAddr, fromType, structElementAssign->getAssignSymbolType());
-    copyValue(structElementAssign->getAssignSymbolType(), valueAddr, elementAddr);
+    shareValue(structElementAssign->getAssignSymbolType(), valueAddr, elementAddr);
     freeAllocatedMemory(structElementAssign->getAssignSymbolType(), valueAddr);
 
   } else if (const auto arrayElementAssign =
@@ -70,7 +70,7 @@ std::any Backend::visitAssignment(std::shared_ptr<ast::statements::AssignmentAst
 
       const auto fromType = ctx->getExpr()->getInferredSymbolType();
       valueAddr = castIfNeeded(ctx, valueAddr, fromType, arrayElementAssign->getAssignSymbolType());
-      copyValue(arrayElementAssign->getAssignSymbolType(), valueAddr, elementAddr);
+      shareValue(arrayElementAssign->getAssignSymbolType(), valueAddr, elementAddr);
       freeAllocatedMemory(arrayElementAssign->getAssignSymbolType(), valueAddr);
 
     } else if (arrayElementAssign->getElementIndex()->getNodeType() ==
@@ -155,13 +155,14 @@ std::any Backend::visitAssignment(std::shared_ptr<ast::statements::AssignmentAst
     if (auto vectorType =
             std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(variableSymbol->getType())) {
       auto newVectorAddr = createVectorValue(vectorType, type, valueAddr);
-      copyValue(vectorType, newVectorAddr, variableSymbol->value);
+      shareValue(vectorType, newVectorAddr, variableSymbol->value);
       freeVector(vectorType, newVectorAddr);
       return {};
     }
     const auto fromType = ctx->getExpr()->getInferredSymbolType();
     valueAddr = castIfNeeded(ctx, valueAddr, fromType, identifierLeft->getAssignSymbolType());
-    copyValue(identifierLeft->getAssignSymbolType(), valueAddr, identifierLeft->getEvaluatedAddr());
+    shareValue(identifierLeft->getAssignSymbolType(), valueAddr,
+               identifierLeft->getEvaluatedAddr());
     freeAllocatedMemory(identifierLeft->getAssignSymbolType(), valueAddr);
   }
   return {};
@@ -26,13 +26,26 @@ std::any Backend::visitDeclaration(std::shared_ptr<ast::statements::DeclarationA
       return {};
     }
   }
-  mlir::Value newAddr = builder->create<mlir::LLVM::AllocaOp>(
-      loc, ptrTy(), getMLIRType(variableSymbol->getType()), constOne());
+  const auto initAddr = valueAddr;
   valueAddr = castIfNeeded(ctx, valueAddr, ctx->getExpr()->getInferredSymbolType(),
                            variableSymbol->getType());
-  copyValue(variableSymbol->getType(), valueAddr, newAddr);
+  // A temporary initializer (e.g. a call result) becomes the variable itself instead of being
+  // copied and freed
+  if (valueAddr == initAddr &&
+      releaseTemporary(ctx->getExpr(), variableSymbol->getType(), valueAddr)) {
+    ctx->getSymbol()->value = valueAddr;
+    ctx->getScope()->pushElementToFree(std::make_pair(variableSymbol->getType(), valueAddr));
+    return {};
+  }
+  mlir::Value newAddr = builder->create<mlir::LLVM::AllocaOp>(
+      loc, ptrTy(), getMLIRType(variableSymbol->getType()), constOne());
+  shareValue(variableSymbol->getType(), valueAddr, newAddr);
   ctx->getSymbol()->value = newAddr;
-  freeAllocatedMemory(variableSymbol->getType(), valueAddr);
+  // A temporary initializer is released with its scope. A variable, or a field that points into
+  // one, stays with its owner, so only a converted copy made by the cast is freed here.
+  if (valueAddr != initAddr) {
+    freeAllocatedMemory(variableSymbol->getType(), valueAddr);
+  }
   return {};
 }
 } // namespace gazprea::backend
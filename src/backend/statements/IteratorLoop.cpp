@@ -7,38 +7,66 @@ namespace gazprea::backend {
 std::any Backend::visitIteratorLoop(std::shared_ptr<ast::statements::IteratorLoopAst> ctx) {
   auto domainExpr = ctx->getDomain();
 
-  visit(domainExpr);
-  auto [domainType, domainArrayAddr] = domainExpr->getScope()->getTopElementInStack();
-  domainExpr->getScope()->popElementFromScopeStack();
-
-  auto domainArrayType = getMLIRType(domainType);
-
-  // Handle both arrays and vectors
-  mlir::Value domainSizeAddr, domainDataPtrAddr, domainSize, domainDataPtr;
-  auto vectorTypeSymbol = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(domainType);
-
-  if (vectorTypeSymbol) {
-    domainSizeAddr = gepOpVector(domainArrayType, domainArrayAddr, VectorOffset::Size);
-    domainSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domainSizeAddr);
-    domainDataPtrAddr = gepOpVector(domainArrayType, domainArrayAddr, VectorOffset::Data);
-    domainDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domainDataPtrAddr);
+  // A range domain is counted directly instead of being materialized as an array. The iterator
+  // is still a fresh copy per iteration, so assigning to it does not affect the loop.
+  auto rangeDomain = getRangeDomain(domainExpr);
+  // Likewise `a by k` steps through the buffer of `a`
+  auto strideDomain = rangeDomain ? nullptr : getStrideDomain(domainExpr);
+
+  std::shared_ptr<symTable::Type> domainType;
+  mlir::Value domainArrayAddr, domainSize, domainDataPtr, rangeStart, strideStep;
+  mlir::Type elementMLIRType;
+
+  if (rangeDomain) {
+    std::tie(rangeStart, domainSize) = emitRangeBounds(rangeDomain);
+    elementMLIRType = intTy();
+  } else if (strideDomain) {
+    auto domain = emitStrideDomain(strideDomain, /*snapshot=*/true);
+    domainType = domain.type;
+    domainArrayAddr = domain.addr;
+    domainDataPtr = domain.dataPtr;
+    domainSize = domain.count;
+    strideStep = domain.step;
+    if (auto vectorTypeSymbol = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(domainType)) {
+      elementMLIRType = getMLIRType(vectorTypeSymbol->getType());
+    } else {
+      elementMLIRType = getMLIRType(
+          std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(domainType)->getType());
+    }
   } else {
-    domainSizeAddr = getArraySizeAddr(*builder, loc, domainArrayType, domainArrayAddr);
-    domainSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domainSizeAddr);
-    domainDataPtrAddr = getArrayDataAddr(*builder, loc, domainArrayType, domainArrayAddr);
-    domainDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domainDataPtrAddr);
-  }
+    visit(domainExpr);
+    std::tie(domainType, domainArrayAddr) = domainExpr->getScope()->getTopElementInStack();
+    domainExpr->getScope()->popElementFromScopeStack();
+
+    auto domainArrayType = getMLIRType(domainType);
+
+    // Handle both arrays and vectors
+    mlir::Value domainSizeAddr, domainDataPtrAddr;
+    auto vectorTypeSymbol = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(domainType);
+
+    if (vectorTypeSymbol) {
+      domainSizeAddr = gepOpVector(domainArrayType, domainArrayAddr, VectorOffset::Size);
+      domainSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domainSizeAddr);
+      domainDataPtrAddr = gepOpVector(domainArrayType, domainArrayAddr, VectorOffset::Data);
+      domainDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domainDataPtrAddr);
+    } else {
+      domainSizeAddr = getArraySizeAddr(*builder, loc, domainArrayType, domainArrayAddr);
+      domainSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), domainSizeAddr);
+      domainDataPtrAddr = getArrayDataAddr(*builder, loc, domainArrayType, domainArrayAddr);
+      domainDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), domainDataPtrAddr);
+    }
 
-  std::shared_ptr<symTable::Type> elementType;
-  auto arrayTypeSymbol = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(domainType);
+    std::shared_ptr<symTable::Type> elementType;
+    auto arrayTypeSymbol = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(domainType);
 
-  if (arrayTypeSymbol) {
-    elementType = arrayTypeSymbol->getType();
-  } else if (vectorTypeSymbol) {
-    elementType = vectorTypeSymbol->getType();
-  }
+    if (arrayTypeSymbol) {
+      elementType = arrayTypeSymbol->getType();
+    } else if (vectorTypeSymbol) {
+      elementType = vectorTypeSymbol->getType();
+    }
 
-  auto elementMLIRType = getMLIRType(elementType);
+    elementMLIRType = getMLIRType(elementType);
+  }
 
   std::string iteratorName = domainExpr->getIteratorName();
 
@@ -75,10 +103,19 @@ std::any Backend::visitIteratorLoop(std::shared_ptr<ast::statements::IteratorLoo
 
   builder->setInsertionPointToStart(bodyBlock);
   auto currentLoopIdx = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), loopIdxAddr);
-  auto domainElementPtr = builder->create<mlir::LLVM::GEPOp>(
-      loc, ptrTy(), elementMLIRType, domainDataPtr, mlir::ValueRange{currentLoopIdx});
-  auto domainElementValue =
-      builder->create<mlir::LLVM::LoadOp>(loc, elementMLIRType, domainElementPtr);
+  mlir::Value domainElementValue;
+  if (rangeDomain) {
+    domainElementValue = builder->create<mlir::LLVM::AddOp>(loc, rangeStart, currentLoopIdx);
+  } else {
+    mlir::Value elementIdx = currentLoopIdx;
+    if (strideStep) {
+      elementIdx = builder->create<mlir::LLVM::MulOp>(loc, currentLoopIdx, strideStep);
+    }
+    auto domainElementPtr = builder->create<mlir::LLVM::GEPOp>(
+        loc, ptrTy(), elementMLIRType, domainDataPtr, mlir::ValueRange{elementIdx});
+    domainElementValue =
+        builder->create<mlir::LLVM::LoadOp>(loc, elementMLIRType, domainElementPtr);
+  }
   auto iteratorAddr =
       builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), elementMLIRType, constOne(), 0);
   builder->create<mlir::LLVM::StoreOp>(loc, domainElementValue, iteratorAddr);
@@ -112,7 +149,9 @@ std::any Backend::visitIteratorLoop(std::shared_ptr<ast::statements::IteratorLoo
   }
 
   builder->setInsertionPointToStart(exitBlock);
-  freeAllocatedMemory(domainType, domainArrayAddr);
+  if (domainArrayAddr) {
+    freeAllocatedMemory(domainType, domainArrayAddr);
+  }
 
   return {};
 }
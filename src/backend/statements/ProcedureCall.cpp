@@ -14,6 +14,9 @@
 namespace gazprea::backend {
 
 std::any Backend::visitProcedureCall(std::shared_ptr<ast::statements::ProcedureCallAst> ctx) {
+  if (emitSelfTailCall(ctx, ctx->getArgs())) {
+    return {};
+  }
   const auto methodSym = std::dynamic_pointer_cast<symTable::MethodSymbol>(ctx->getSymbol());
   const auto procedureDeclaration =
       std::dynamic_pointer_cast<ast::prototypes::ProcedureAst>(methodSym->getDef());
@@ -22,6 +25,7 @@ std::any Backend::visitProcedureCall(std::shared_ptr<ast::statements::ProcedureC
   const auto params = prototype->getParams();
   const auto args = ctx->getArgs();
   std::vector<mlir::Value> mlirArgs;
+  std::vector<bool> passedByReference(args.size(), false);
 
   auto emitSizeErrorIf = [&](mlir::Value predicate) {
     builder->create<mlir::scf::IfOp>(
@@ -179,24 +183,31 @@ std::any Backend::visitProcedureCall(std::shared_ptr<ast::statements::ProcedureC
       };
 
   for (size_t i = 0; i < ctx->getArgs().size(); ++i) {
-    visit(args[i]);
-    auto [valueType, valueAddr] = popElementFromStack(args[i]);
     auto variableSymbol =
         std::dynamic_pointer_cast<symTable::VariableSymbol>(params[i]->getSymbol());
-
     const bool isVarParam = variableSymbol && variableSymbol->getQualifier() == ast::Qualifier::Var;
+    evaluatingVarArg = isVarParam;
+    visit(args[i]);
+    evaluatingVarArg = false;
+    auto [valueType, valueAddr] = popElementFromStack(args[i]);
     auto paramAst = std::dynamic_pointer_cast<ast::prototypes::ProcedureParamAst>(params[i]);
     auto paramTypeAst = paramAst ? paramAst->getParamType() : nullptr;
     if (isVarParam) {
       checkSizes(paramTypeAst, valueType, valueAddr);
     }
 
-    // castIfNeeded now handles scalar-to-array conversion and returns the final address
-    if (variableSymbol->getQualifier() == ast::Qualifier::Const) {
+    if (variableSymbol->getQualifier() == ast::Qualifier::Const &&
+        canPassByReference(paramTypeAst, valueType, variableSymbol->getType())) {
+      // Read in place by the procedure, see visitFuncProcCall
+      params[i]->getSymbol()->value = valueAddr;
+      mlirArgs.push_back(valueAddr);
+      passedByReference[i] = true;
+    } else if (variableSymbol->getQualifier() == ast::Qualifier::Const) {
+      // castIfNeeded now handles scalar-to-array conversion and returns the final address
       params[i]->getSymbol()->value = builder->create<mlir::LLVM::AllocaOp>(
           loc, ptrTy(), getMLIRType(variableSymbol->getType()), constOne());
       valueAddr = castIfNeeded(params[i], valueAddr, valueType, variableSymbol->getType());
-      copyValue(variableSymbol->getType(), valueAddr, params[i]->getSymbol()->value);
+      shareValue(variableSymbol->getType(), valueAddr, params[i]->getSymbol()->value);
       mlirArgs.push_back(params[i]->getSymbol()->value);
       freeAllocatedMemory(variableSymbol->getType(), valueAddr);
     } else {
@@ -211,7 +222,7 @@ std::any Backend::visitProcedureCall(std::shared_ptr<ast::statements::ProcedureC
   for (size_t i = 0; i < ctx->getArgs().size(); ++i) {
     if (auto variableSymbol =
             std::dynamic_pointer_cast<symTable::VariableSymbol>(params[i]->getSymbol());
-        variableSymbol->getQualifier() == ast::Qualifier::Const) {
+        variableSymbol->getQualifier() == ast::Qualifier::Const && !passedByReference[i]) {
       freeAllocatedMemory(variableSymbol->getType(), params[i]->getSymbol()->value);
     }
   }
@@ -15,6 +15,13 @@ std::any Backend::visitReturn(std::shared_ptr<ast::statements::ReturnAst> ctx) {
     return {};
   }
 
+  if (const auto router =
+          std::dynamic_pointer_cast<ast::expressions::StructFuncCallRouterAst>(ctx->getExpr());
+      router && !router->getIsStruct() &&
+      emitSelfTailCall(ctx, router->getFuncProcCallAst()->getArgs())) {
+    return {};
+  }
+
   visit(ctx->getExpr());
   auto [returnType, returnValue] = popElementFromStack(ctx->getExpr());
 
@@ -42,15 +49,30 @@ std::any Backend::visitReturn(std::shared_ptr<ast::statements::ReturnAst> ctx) {
       }
     }
   }
+  const auto resultAddr = returnValue;
   returnValue = castIfNeeded(ctx, returnValue, returnType, methodReturnType);
 
+  // A temporary result is handed to the caller as it is; its buffers become the caller's
+  if (returnValue == resultAddr &&
+      releaseTemporary(ctx->getExpr(), methodReturnType, returnValue)) {
+    auto loadOp =
+        builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(methodReturnType), returnValue);
+    builder->create<mlir::LLVM::ReturnOp>(builder->getUnknownLoc(), loadOp.getResult());
+    return {};
+  }
+
   // Create a copy of the return value
   auto returnCopy = builder->create<mlir::LLVM::AllocaOp>(
       loc, ptrTy(), getMLIRType(methodReturnType), constOne());
   copyValue(methodReturnType, returnValue, returnCopy);
 
-  // Now free the original returnValue if it's heap-allocated
-  freeAllocatedMemory(methodReturnType, returnValue);
+  // Now free the original returnValue if it's heap-allocated. A field of a tuple or struct points
+  // into its owner, which may be a const param read in place from the caller.
+  const auto exprType = ctx->getExpr()->getNodeType();
+  if (returnValue != resultAddr || (exprType != ast::NodeType::TupleAccess &&
+                                    exprType != ast::NodeType::StructAccess)) {
+    freeAllocatedMemory(methodReturnType, returnValue);
+  }
 
   // Load and return the copy
   auto loadOp = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(methodReturnType), returnCopy);
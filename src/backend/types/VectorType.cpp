@@ -444,20 +444,7 @@ void Backend::copyVectorStruct(std::shared_ptr<symTable::Type> type, mlir::Value
           b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
         });
   } else {
-    // For scalar elements, simple load/store
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), srcSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto srcElemPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, srcDataPtr,
-                                                        mlir::ValueRange{i});
-          auto destElemPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, destDataPtr,
-                                                         mlir::ValueRange{i});
-
-          auto elementValue = b.create<mlir::LLVM::LoadOp>(l, elementMLIRType, srcElemPtr);
-          b.create<mlir::LLVM::StoreOp>(l, elementValue, destElemPtr);
-
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
+    copyElements(*builder, loc, destDataPtr, srcDataPtr, elementMLIRType, srcSize);
   }
 }
 
@@ -875,35 +862,10 @@ mlir::Value Backend::concatVectors(std::shared_ptr<symTable::Type> type,
           b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
         });
   } else {
-    // For scalar elements, simple load/store
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), leftVectorSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto srcPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, leftDataPtr,
-                                                    mlir::ValueRange{i});
-          auto dstPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, newDataPtr,
-                                                    mlir::ValueRange{i});
-
-          auto value = b.create<mlir::LLVM::LoadOp>(l, elementMLIRType, srcPtr);
-          b.create<mlir::LLVM::StoreOp>(l, value, dstPtr);
-
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
-
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), rightVectorSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto offset = b.create<mlir::LLVM::AddOp>(l, leftVectorSize, i);
-          auto srcPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, rightDataPtr,
-                                                    mlir::ValueRange{i});
-          auto dstPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, newDataPtr,
-                                                    mlir::ValueRange{offset});
-
-          auto value = b.create<mlir::LLVM::LoadOp>(l, elementMLIRType, srcPtr);
-          b.create<mlir::LLVM::StoreOp>(l, value, dstPtr);
-
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
+    copyElements(*builder, loc, newDataPtr, leftDataPtr, elementMLIRType, leftVectorSize);
+    auto rightDestPtr = builder->create<mlir::LLVM::GEPOp>(
+        loc, ptrTy(), elementMLIRType, newDataPtr, mlir::ValueRange{leftVectorSize});
+    copyElements(*builder, loc, rightDestPtr, rightDataPtr, elementMLIRType, rightVectorSize);
   }
 
   // Set the data pointer in the new vector struct
@@ -928,6 +890,32 @@ mlir::Value Backend::concatVectors(std::shared_ptr<symTable::Type> type,
   return newVectorStruct;
 }
 
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateVectorPushNFunc() {
+  auto pushNFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kVectorPushNName);
+  if (pushNFunc) {
+    return pushNFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: ptr vectorPushN(ptr vectorStruct, i32 count, i64 elementSize)
+  auto pushNFnType = mlir::LLVM::LLVMFunctionType::get(
+      ptrTy(), {ptrTy(), intTy(), builder->getI64Type()}, /*isVarArg=*/false);
+  pushNFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kVectorPushNName, pushNFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return pushNFunc;
+}
+
+// Grows the vector by `count` elements through the runtime, which reallocates geometrically, and
+// returns the address of the first new slot. The size field is already updated on return.
+mlir::Value Backend::pushVectorSlots(mlir::Value vectorStruct, mlir::Type elementMLIRType,
+                                     mlir::Value count) {
+  auto elementSize = getByteCount(*builder, loc, elementMLIRType, constOne());
+  return builder
+      ->create<mlir::LLVM::CallOp>(loc, getOrCreateVectorPushNFunc(),
+                                   mlir::ValueRange{vectorStruct, count, elementSize})
+      .getResult();
+}
+
 void Backend::throwIfVectorSizeNotEqual(mlir::Value left, mlir::Value right,
                                         std::shared_ptr<symTable::Type> type) {
   auto vectorTypeSym = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(type);
@@ -1015,9 +1003,6 @@ void Backend::throwIfVectorSizeNotEqual(mlir::Value left, mlir::Value right,
 
 mlir::Value Backend::strideVectorByScalar(std::shared_ptr<symTable::Type> type,
                                           mlir::Value vectorStruct, mlir::Value scalarValue) {
-  auto newSizeAddr = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), intTy(), constOne());
-  builder->create<mlir::LLVM::StoreOp>(loc, constZero(), newSizeAddr);
-
   auto vectorTypeSym = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(type);
   if (!vectorTypeSym) {
     return {};
@@ -1051,15 +1036,7 @@ mlir::Value Backend::strideVectorByScalar(std::shared_ptr<symTable::Type> type,
   auto elementArrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(elementType);
 
   // Count how many elements we'll have after striding
-  builder->create<mlir::scf::ForOp>(
-      loc, constZero(), vectorSize, scalarValue, mlir::ValueRange{},
-      [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-        auto newSize = b.create<mlir::LLVM::LoadOp>(l, intTy(), newSizeAddr);
-        auto incrementedSize = b.create<mlir::LLVM::AddOp>(l, newSize, constOne());
-        b.create<mlir::LLVM::StoreOp>(l, incrementedSize, newSizeAddr);
-        b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-      });
-  auto newSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), newSizeAddr);
+  auto newSize = getStridedCount(vectorSize, scalarValue);
 
   // Create new vector struct
   auto newVectorStruct =
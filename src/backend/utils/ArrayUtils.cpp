@@ -342,33 +342,11 @@ void Backend::fillArrayFromScalar(mlir::Value arrayStruct,
     auto innerElementMLIRType = getMLIRType(innerElementType);
     mlir::Value outerSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), sizes[0]);
     mlir::Value innerSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), sizes[1]);
-    auto subArrayStructType = getMLIRType(elementArrayType);
-    mlir::Value outerDataPtr = mallocArray(subArrayStructType, outerSize);
-
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), outerSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto subArrayPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), subArrayStructType,
-                                                         outerDataPtr, mlir::ValueRange{i});
-          mlir::Value innerDataPtr = mallocArray(innerElementMLIRType, innerSize);
-          b.create<mlir::scf::ForOp>(l, constZero(), innerSize, constOne(), mlir::ValueRange{},
-                                     [&](mlir::OpBuilder &b2, mlir::Location l2, mlir::Value j,
-                                         mlir::ValueRange iterArgs2) {
-                                       auto elementPtr = b2.create<mlir::LLVM::GEPOp>(
-                                           l2, ptrTy(), innerElementMLIRType, innerDataPtr,
-                                           mlir::ValueRange{j});
-                                       b2.create<mlir::LLVM::StoreOp>(l2, scalarValue, elementPtr);
-                                       b2.create<mlir::scf::YieldOp>(l2, mlir::ValueRange{});
-                                     });
-          auto subArrayDataAddr = getArrayDataAddr(b, l, subArrayStructType, subArrayPtr);
-          b.create<mlir::LLVM::StoreOp>(l, innerDataPtr, subArrayDataAddr);
-          auto subArraySizeAddr = getArraySizeAddr(b, l, subArrayStructType, subArrayPtr);
-          b.create<mlir::LLVM::StoreOp>(l, innerSize, subArraySizeAddr);
-          auto subIs2DFieldPtr = get2DArrayBoolAddr(b, l, subArrayStructType, subArrayPtr);
-          auto boolFalse = b.create<mlir::LLVM::ConstantOp>(l, boolTy(), 0);
-          b.create<mlir::LLVM::StoreOp>(l, boolFalse, subIs2DFieldPtr);
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
+    mlir::Value outerDataPtr = mallocMatrix(innerElementMLIRType, outerSize, innerSize);
+    auto elements = getMatrixElements(*builder, loc, outerDataPtr, outerSize);
+    // The rows are contiguous, so the whole matrix is filled at once
+    auto elementCount = builder->create<mlir::LLVM::MulOp>(loc, outerSize, innerSize);
+    fillElements(*builder, loc, elements, innerElementMLIRType, scalarValue, elementCount);
     auto arrayDataAddr = getArrayDataAddr(*builder, loc, arrayStructType, arrayStruct);
     builder->create<mlir::LLVM::StoreOp>(loc, outerDataPtr, arrayDataAddr);
     auto arraySizeAddr = getArraySizeAddr(*builder, loc, arrayStructType, arrayStruct);
@@ -381,14 +359,7 @@ void Backend::fillArrayFromScalar(mlir::Value arrayStruct,
     mlir::Value targetSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), sizes[0]);
     auto elementMLIRType = getMLIRType(elementType);
     mlir::Value arrayDataPtr = mallocArray(elementMLIRType, targetSize);
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), targetSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto elementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, arrayDataPtr,
-                                                        mlir::ValueRange{i});
-          b.create<mlir::LLVM::StoreOp>(l, scalarValue, elementPtr);
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
+    fillElements(*builder, loc, arrayDataPtr, elementMLIRType, scalarValue, targetSize);
     auto arrayDataAddr = getArrayDataAddr(*builder, loc, arrayStructType, arrayStruct);
     builder->create<mlir::LLVM::StoreOp>(loc, arrayDataPtr, arrayDataAddr);
     auto arraySizeAddr = getArraySizeAddr(*builder, loc, arrayStructType, arrayStruct);
@@ -627,49 +598,15 @@ void Backend::fillArrayWithScalar(mlir::Value arrayStruct,
   auto scalarMLIRType = getMLIRType(scalarType);
 
   if (elementArrayType) {
-    // 2D array case - allocate memory for outer and inner arrays
+    // 2D array case - one dense block for the rows and their elements
     auto innerElementType = elementArrayType->getType();
     auto innerElementMLIRType = getMLIRType(innerElementType);
-    auto subArrayStructType = getMLIRType(elementType);
-
-    // Allocate outer array
-    mlir::Value outerDataPtr = mallocArray(subArrayStructType, targetOuterSize);
 
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), targetOuterSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto subArrayPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), subArrayStructType,
-                                                         outerDataPtr, mlir::ValueRange{i});
-
-          // Allocate inner array
-          mlir::Value innerDataPtr = mallocArray(innerElementMLIRType, targetInnerSize);
-
-          // Fill inner array with scalar
-          b.create<mlir::scf::ForOp>(
-              l, constZero(), targetInnerSize, constOne(), mlir::ValueRange{},
-              [&](mlir::OpBuilder &b2, mlir::Location l2, mlir::Value j,
-                  mlir::ValueRange iterArgs2) {
-                auto elementPtr = b2.create<mlir::LLVM::GEPOp>(l2, ptrTy(), scalarMLIRType,
-                                                               innerDataPtr, mlir::ValueRange{j});
-                b2.create<mlir::LLVM::StoreOp>(l2, scalarValue, elementPtr);
-                b2.create<mlir::scf::YieldOp>(l2, mlir::ValueRange{});
-              });
-
-          // Store inner data pointer in sub-array struct
-          auto subArrayDataAddr = getArrayDataAddr(b, l, subArrayStructType, subArrayPtr);
-          b.create<mlir::LLVM::StoreOp>(l, innerDataPtr, subArrayDataAddr);
-
-          // Store inner size in sub-array struct
-          auto subArraySizeAddr = getArraySizeAddr(b, l, subArrayStructType, subArrayPtr);
-          b.create<mlir::LLVM::StoreOp>(l, targetInnerSize, subArraySizeAddr);
-
-          // Set is2D flag for sub-array
-          auto subIs2DFieldPtr = get2DArrayBoolAddr(b, l, subArrayStructType, subArrayPtr);
-          auto boolFalse = b.create<mlir::LLVM::ConstantOp>(l, boolTy(), 0);
-          b.create<mlir::LLVM::StoreOp>(l, boolFalse, subIs2DFieldPtr);
-
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
+    mlir::Value outerDataPtr = mallocMatrix(innerElementMLIRType, targetOuterSize, targetInnerSize);
+    auto elements = getMatrixElements(*builder, loc, outerDataPtr, targetOuterSize);
+    auto elementCount =
+        builder->create<mlir::LLVM::MulOp>(loc, targetOuterSize, targetInnerSize);
+    fillElements(*builder, loc, elements, scalarMLIRType, scalarValue, elementCount);
 
     // Store outer data pointer in main array struct
     auto arrayDataAddr = getArrayDataAddr(*builder, loc, arrayStructType, arrayStruct);
@@ -688,16 +625,7 @@ void Backend::fillArrayWithScalar(mlir::Value arrayStruct,
     // 1D array case - allocate memory
     auto elementMLIRType = getMLIRType(elementType);
     mlir::Value arrayDataPtr = mallocArray(elementMLIRType, targetOuterSize);
-
-    // Fill array with scalar
-    builder->create<mlir::scf::ForOp>(
-        loc, constZero(), targetOuterSize, constOne(), mlir::ValueRange{},
-        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto elementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, arrayDataPtr,
-                                                        mlir::ValueRange{i});
-          b.create<mlir::LLVM::StoreOp>(l, scalarValue, elementPtr);
-          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-        });
+    fillElements(*builder, loc, arrayDataPtr, elementMLIRType, scalarValue, targetOuterSize);
 
     // Store data pointer in array struct
     auto arrayDataAddr = getArrayDataAddr(*builder, loc, arrayStructType, arrayStruct);
@@ -1118,6 +1046,39 @@ mlir::Value Backend::mallocArray(mlir::Type elementMLIRType, mlir::Value element
       .getResult();
 }
 
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateMatrixAllocFunc() {
+  auto matrixAllocFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kMatrixAllocName);
+  if (matrixAllocFunc) {
+    return matrixAllocFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: ptr matrixAlloc(i32 rows, i32 cols, i64 elementSize)
+  auto matrixAllocFnType = mlir::LLVM::LLVMFunctionType::get(
+      ptrTy(), {intTy(), intTy(), builder->getI64Type()}, /*isVarArg=*/false);
+  matrixAllocFunc =
+      builder->create<mlir::LLVM::LLVMFuncOp>(loc, kMatrixAllocName, matrixAllocFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return matrixAllocFunc;
+}
+
+// Allocates the data of a 2D array as one block: `rows` row headers (already initialized to `cols`
+// elements each) followed by the elements in row-major order. Row data pointers point into the
+// block and the whole matrix is released by freeing the block.
+mlir::Value Backend::mallocMatrix(mlir::Type elementMLIRType, mlir::Value rows, mlir::Value cols) {
+  auto matrixAllocFunc = getOrCreateMatrixAllocFunc();
+  auto elementSize = builder->create<mlir::LLVM::SExtOp>(loc, builder->getI64Type(),
+                                                         getTypeSizeInBytes(elementMLIRType));
+  return builder
+      ->create<mlir::LLVM::CallOp>(loc, matrixAllocFunc, mlir::ValueRange{rows, cols, elementSize})
+      .getResult();
+}
+
+mlir::Value Backend::getMatrixElements(mlir::OpBuilder &b, mlir::Location l,
+                                       mlir::Value matrixData, mlir::Value rows) {
+  return b.create<mlir::LLVM::GEPOp>(l, ptrTy(), arrayTy(), matrixData, mlir::ValueRange{rows});
+}
+
 mlir::Value Backend::getTypeSizeInBytes(mlir::Type elementType) {
   auto tempAlloc = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), elementType, constOne());
   auto i64Type = builder->getI64Type();
@@ -1130,6 +1091,54 @@ mlir::Value Backend::getTypeSizeInBytes(mlir::Type elementType) {
   return builder->create<mlir::LLVM::TruncOp>(loc, intTy(), elementSizeI64);
 }
 
+// Size in bytes of `count` (i32) elements as an i64, for the memory intrinsics. A negative count,
+// such as the size of a reversed range, is clamped to zero like the loops these calls replaced.
+mlir::Value Backend::getByteCount(mlir::OpBuilder &b, mlir::Location l, mlir::Type elementType,
+                                  mlir::Value count) {
+  auto i64Type = b.getI64Type();
+  auto zero = b.create<mlir::LLVM::ConstantOp>(l, count.getType(), 0);
+  auto isNegative = b.create<mlir::LLVM::ICmpOp>(l, mlir::LLVM::ICmpPredicate::slt, count, zero);
+  auto clampedCount = b.create<mlir::LLVM::SelectOp>(l, isNegative, zero, count);
+  auto countI64 = b.create<mlir::LLVM::SExtOp>(l, i64Type, clampedCount);
+  auto nullPtr = b.create<mlir::LLVM::ZeroOp>(l, ptrTy());
+  auto endPtr =
+      b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementType, nullPtr, mlir::ValueRange{countI64});
+  return b.create<mlir::LLVM::PtrToIntOp>(l, i64Type, endPtr);
+}
+
+void Backend::copyElements(mlir::OpBuilder &b, mlir::Location l, mlir::Value destPtr,
+                           mlir::Value srcPtr, mlir::Type elementType, mlir::Value count) {
+  b.create<mlir::LLVM::MemcpyOp>(l, destPtr, srcPtr, getByteCount(b, l, elementType, count),
+                                 /*isVolatile=*/false);
+}
+
+// Zero fills (every default value) become a memset, anything else a store loop
+void Backend::fillElements(mlir::OpBuilder &b, mlir::Location l, mlir::Value dataPtr,
+                           mlir::Type elementType, mlir::Value value, mlir::Value count) {
+  bool isZero = false;
+  if (auto constant = value.getDefiningOp<mlir::LLVM::ConstantOp>()) {
+    if (auto intAttr = mlir::dyn_cast<mlir::IntegerAttr>(constant.getValue())) {
+      isZero = intAttr.getValue().isZero();
+    } else if (auto floatAttr = mlir::dyn_cast<mlir::FloatAttr>(constant.getValue())) {
+      isZero = floatAttr.getValue().isPosZero();
+    }
+  }
+  if (isZero) {
+    auto zeroByte = b.create<mlir::LLVM::ConstantOp>(l, b.getI8Type(), 0);
+    b.create<mlir::LLVM::MemsetOp>(l, dataPtr, zeroByte, getByteCount(b, l, elementType, count),
+                                   /*isVolatile=*/false);
+    return;
+  }
+  b.create<mlir::scf::ForOp>(
+      l, constZero(), count, constOne(), mlir::ValueRange{},
+      [&](mlir::OpBuilder &b2, mlir::Location l2, mlir::Value i, mlir::ValueRange iterArgs) {
+        auto elementPtr =
+            b2.create<mlir::LLVM::GEPOp>(l2, ptrTy(), elementType, dataPtr, mlir::ValueRange{i});
+        b2.create<mlir::LLVM::StoreOp>(l2, value, elementPtr);
+        b2.create<mlir::scf::YieldOp>(l2, mlir::ValueRange{});
+      });
+}
+
 mlir::Value Backend::getDefaultValue(std::shared_ptr<symTable::Type> type) {
   std::string typeName = type->getName();
 
@@ -1431,41 +1440,74 @@ mlir::Value Backend::copyArray(std::shared_ptr<symTable::Type> elementType, mlir
     return builder->create<mlir::LLVM::ZeroOp>(loc, ptrTy());
   }
 
-  mlir::Value destDataPtr = mallocArray(elementMLIRType, size);
-
   auto elementArrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(elementType);
 
-  if (elementArrayType) {
-    auto subArrayStructType = getMLIRType(elementType);
+  if (elementArrayType && isScalarType(elementArrayType->getType())) {
+    // Matrices are copied into dense storage. Rows may still be ragged before padding, so the
+    // row stride is the widest source row and each row keeps its own size.
+    auto innerElementMLIRType = getMLIRType(elementArrayType->getType());
+    auto widestRow = builder->create<mlir::scf::ForOp>(
+        loc, constZero(), size, constOne(), mlir::ValueRange{constZero()},
+        [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
+          auto srcRowPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, srcDataPtr,
+                                                       mlir::ValueRange{i});
+          auto srcRowSizeAddr = getArraySizeAddr(b, l, elementMLIRType, srcRowPtr);
+          mlir::Value srcRowSize = b.create<mlir::LLVM::LoadOp>(l, intTy(), srcRowSizeAddr);
+          auto wider = b.create<mlir::LLVM::ICmpOp>(l, mlir::LLVM::ICmpPredicate::sgt, srcRowSize,
+                                                    iterArgs[0]);
+          mlir::Value newWidest = b.create<mlir::LLVM::SelectOp>(l, wider, srcRowSize, iterArgs[0]);
+          b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{newWidest});
+        });
+    mlir::Value cols = widestRow.getResult(0);
+
+    mlir::Value destDataPtr = mallocMatrix(innerElementMLIRType, size, cols);
+    auto destElements = getMatrixElements(*builder, loc, destDataPtr, size);
 
     builder->create<mlir::scf::ForOp>(
         loc, constZero(), size, constOne(), mlir::ValueRange{},
         [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto srcSubArrayPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), subArrayStructType,
-                                                            srcDataPtr, mlir::ValueRange{i});
+          auto srcRowPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, srcDataPtr,
+                                                       mlir::ValueRange{i});
+          auto srcRowSizeAddr = getArraySizeAddr(b, l, elementMLIRType, srcRowPtr);
+          mlir::Value srcRowSize = b.create<mlir::LLVM::LoadOp>(l, intTy(), srcRowSizeAddr);
+          auto srcRowDataAddr = getArrayDataAddr(b, l, elementMLIRType, srcRowPtr);
+          mlir::Value srcRowData = b.create<mlir::LLVM::LoadOp>(l, ptrTy(), srcRowDataAddr);
 
-          auto destSubArrayPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), subArrayStructType,
-                                                             destDataPtr, mlir::ValueRange{i});
+          auto destRowPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, destDataPtr,
+                                                        mlir::ValueRange{i});
+          auto destRowSizeAddr = getArraySizeAddr(b, l, elementMLIRType, destRowPtr);
+          b.create<mlir::LLVM::StoreOp>(l, srcRowSize, destRowSizeAddr);
 
-          copyArrayStruct(elementType, srcSubArrayPtr, destSubArrayPtr);
+          auto rowStart = b.create<mlir::LLVM::MulOp>(l, i, cols);
+          auto destRowData = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), innerElementMLIRType,
+                                                         destElements, mlir::ValueRange{rowStart});
+          copyElements(b, l, destRowData, srcRowData, innerElementMLIRType, srcRowSize);
 
           b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
         });
-  } else {
+    return destDataPtr;
+  }
+
+  mlir::Value destDataPtr = mallocArray(elementMLIRType, size);
+
+  if (elementArrayType) {
+    auto subArrayStructType = getMLIRType(elementType);
+
     builder->create<mlir::scf::ForOp>(
         loc, constZero(), size, constOne(), mlir::ValueRange{},
         [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-          auto srcElementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType, srcDataPtr,
-                                                           mlir::ValueRange{i});
+          auto srcSubArrayPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), subArrayStructType,
+                                                            srcDataPtr, mlir::ValueRange{i});
 
-          auto destElementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), elementMLIRType,
-                                                            destDataPtr, mlir::ValueRange{i});
+          auto destSubArrayPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), subArrayStructType,
+                                                             destDataPtr, mlir::ValueRange{i});
 
-          mlir::Value element = b.create<mlir::LLVM::LoadOp>(l, elementMLIRType, srcElementPtr);
-          b.create<mlir::LLVM::StoreOp>(l, element, destElementPtr);
+          copyArrayStruct(elementType, srcSubArrayPtr, destSubArrayPtr);
 
           b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
         });
+  } else {
+    copyElements(*builder, loc, destDataPtr, srcDataPtr, elementMLIRType, size);
   }
 
   return destDataPtr;
@@ -1507,6 +1549,112 @@ void Backend::copyArrayStruct(std::shared_ptr<symTable::Type> type, mlir::Value
   auto destIs2DFieldPtr = get2DArrayBoolAddr(*builder, loc, arrayStructType, destArrayStruct);
   builder->create<mlir::LLVM::StoreOp>(loc, srcIs2D, destIs2DFieldPtr);
 }
+
+bool Backend::isSharableType(const std::shared_ptr<symTable::Type> &type) const {
+  std::shared_ptr<symTable::Type> elementType;
+  if (const auto arrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(type)) {
+    elementType = arrayType->getType();
+  } else if (const auto vectorType = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(type)) {
+    elementType = vectorType->getType();
+  }
+  // Nested arrays are excluded since their rows may live inside a dense matrix block
+  return elementType && isScalarType(elementType);
+}
+
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateBufferShareFunc() {
+  auto shareFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kBufferShareName);
+  if (shareFunc) {
+    return shareFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: ptr bufferShare(ptr data, i64 bytes)
+  auto shareFnType = mlir::LLVM::LLVMFunctionType::get(ptrTy(), {ptrTy(), builder->getI64Type()},
+                                                       /*isVarArg=*/false);
+  shareFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kBufferShareName, shareFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return shareFunc;
+}
+
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateBufferUnshareFunc() {
+  auto unshareFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kBufferUnshareName);
+  if (unshareFunc) {
+    return unshareFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: ptr bufferUnshare(ptr data, i64 bytes)
+  auto unshareFnType = mlir::LLVM::LLVMFunctionType::get(ptrTy(), {ptrTy(), builder->getI64Type()},
+                                                         /*isVarArg=*/false);
+  unshareFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kBufferUnshareName, unshareFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return unshareFunc;
+}
+
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateBufferViewFunc() {
+  auto viewFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kBufferViewName);
+  if (viewFunc) {
+    return viewFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: ptr bufferView(ptr data, ptr start, i64 bytes)
+  auto viewFnType = mlir::LLVM::LLVMFunctionType::get(
+      ptrTy(), {ptrTy(), ptrTy(), builder->getI64Type()}, /*isVarArg=*/false);
+  viewFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, kBufferViewName, viewFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return viewFunc;
+}
+
+// Returns the address of the data field and the size in bytes of the allocated buffer, which for
+// vectors includes the spare capacity
+std::pair<mlir::Value, mlir::Value> Backend::getBufferExtent(std::shared_ptr<symTable::Type> type,
+                                                             mlir::Value containerAddr) {
+  auto structType = getMLIRType(type);
+  mlir::Value dataAddr;
+  mlir::Value countAddr;
+  std::shared_ptr<symTable::Type> elementType;
+  if (const auto vectorType = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(type)) {
+    dataAddr = gepOpVector(structType, containerAddr, VectorOffset::Data);
+    countAddr = gepOpVector(structType, containerAddr, VectorOffset::Capacity);
+    elementType = vectorType->getType();
+  } else {
+    dataAddr = getArrayDataAddr(*builder, loc, structType, containerAddr);
+    countAddr = getArraySizeAddr(*builder, loc, structType, containerAddr);
+    elementType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(type)->getType();
+  }
+  mlir::Value count = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), countAddr);
+  return {dataAddr, getByteCount(*builder, loc, getMLIRType(elementType), count)};
+}
+
+// Copies like copyValue, except that a sharable value hands out its data buffer instead of
+// duplicating it. Only safe for sources whose writers all go through makeBufferUnique.
+void Backend::shareValue(std::shared_ptr<symTable::Type> type, mlir::Value fromAddr,
+                         mlir::Value destAddr) {
+  if (!isSharableType(type)) {
+    copyValue(type, fromAddr, destAddr);
+    return;
+  }
+  auto structValue = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(type), fromAddr);
+  builder->create<mlir::LLVM::StoreOp>(loc, structValue, destAddr);
+  auto [dataAddr, bytes] = getBufferExtent(type, destAddr);
+  mlir::Value dataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr);
+  auto sharedPtr = builder->create<mlir::LLVM::CallOp>(loc, getOrCreateBufferShareFunc(),
+                                                       mlir::ValueRange{dataPtr, bytes});
+  builder->create<mlir::LLVM::StoreOp>(loc, sharedPtr.getResult(), dataAddr);
+}
+
+void Backend::makeBufferUnique(std::shared_ptr<symTable::Type> type, mlir::Value containerAddr) {
+  if (!isSharableType(type)) {
+    return;
+  }
+  auto [dataAddr, bytes] = getBufferExtent(type, containerAddr);
+  mlir::Value dataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), dataAddr);
+  auto uniquePtr = builder->create<mlir::LLVM::CallOp>(loc, getOrCreateBufferUnshareFunc(),
+                                                       mlir::ValueRange{dataPtr, bytes});
+  builder->create<mlir::LLVM::StoreOp>(loc, uniquePtr.getResult(), dataAddr);
+}
+
 bool Backend::isTypeTuple(const std::shared_ptr<symTable::Type> &value) {
   return value->getName() == "tuple";
 }
@@ -1583,6 +1731,7 @@ void Backend::freeArray(std::shared_ptr<symTable::Type> type, mlir::Value arrayS
   if (elementArrayType) {
     auto subArrayStructType = getMLIRType(elementType);
 
+    // Rows living in a dense matrix block are skipped by the runtime free and released with it
     builder->create<mlir::scf::ForOp>(
         loc, constZero(), arraySize, constOne(), mlir::ValueRange{},
         [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
@@ -1740,6 +1889,36 @@ Backend::convertVectorToArrayStruct(mlir::Value vectorStruct,
   return {arrayStruct, arrayType};
 }
 
+// Like convertVectorToArrayStruct, but the array header borrows the vector's buffer. For readers
+// only: the result must not be freed or outlive the vector.
+std::pair<mlir::Value, std::shared_ptr<symTable::ArrayTypeSymbol>>
+Backend::viewVectorAsArrayStruct(mlir::Value vectorStruct,
+                                 std::shared_ptr<symTable::VectorTypeSymbol> vectorType) {
+  auto arrayType = std::make_shared<symTable::ArrayTypeSymbol>("array");
+  arrayType->setType(vectorType->getType());
+
+  auto vectorStructType = getMLIRType(vectorType);
+  auto arrayStructType = getMLIRType(arrayType);
+  auto arrayStruct =
+      builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), arrayStructType, constOne());
+
+  auto vectorSizeAddr = gepOpVector(vectorStructType, vectorStruct, VectorOffset::Size);
+  auto vectorSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), vectorSizeAddr);
+  auto vectorDataAddr = gepOpVector(vectorStructType, vectorStruct, VectorOffset::Data);
+  auto vectorDataPtr = builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), vectorDataAddr);
+  auto vectorIs2DAddr = gepOpVector(vectorStructType, vectorStruct, VectorOffset::Is2D);
+  auto vectorIs2D = builder->create<mlir::LLVM::LoadOp>(loc, boolTy(), vectorIs2DAddr);
+
+  auto arraySizeAddr = getArraySizeAddr(*builder, loc, arrayStructType, arrayStruct);
+  builder->create<mlir::LLVM::StoreOp>(loc, vectorSize, arraySizeAddr);
+  auto arrayDataAddr = getArrayDataAddr(*builder, loc, arrayStructType, arrayStruct);
+  builder->create<mlir::LLVM::StoreOp>(loc, vectorDataPtr, arrayDataAddr);
+  auto arrayIs2DAddr = get2DArrayBoolAddr(*builder, loc, arrayStructType, arrayStruct);
+  builder->create<mlir::LLVM::StoreOp>(loc, vectorIs2D, arrayIs2DAddr);
+
+  return {arrayStruct, arrayType};
+}
+
 void Backend::createArrayFromVector(
     std::vector<std::shared_ptr<ast::expressions::ExpressionAst>> elements,
     mlir::Type elementMLIRType, mlir::Value dest,
@@ -1994,10 +2173,33 @@ mlir::Value Backend::concatArrays(std::shared_ptr<symTable::Type> type, mlir::Va
   return newArrayStruct;
 }
 
+void Backend::throwIfStrideNotPositive(mlir::Value step) {
+  auto isStepLessThanOne =
+      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::slt, step, constOne());
+  builder->create<mlir::scf::IfOp>(
+      loc, isStepLessThanOne,
+      [&](mlir::OpBuilder &b, mlir::Location l) {
+        auto throwStrideErrorFunc =
+            module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kThrowStrideErrorName);
+        b.create<mlir::LLVM::CallOp>(l, throwStrideErrorFunc, mlir::ValueRange{});
+        b.create<mlir::scf::YieldOp>(l);
+      },
+      [&](mlir::OpBuilder &b, mlir::Location l) { b.create<mlir::scf::YieldOp>(l); });
+}
+
+// Number of elements `size` elements leave when taking every `step`th one, ceil(size / step).
+// Computed as (size - 1) / step + 1 so that a large step cannot overflow.
+mlir::Value Backend::getStridedCount(mlir::Value size, mlir::Value step) {
+  auto sizeLessOne = builder->create<mlir::LLVM::SubOp>(loc, size, constOne());
+  auto lastIndex = builder->create<mlir::LLVM::SDivOp>(loc, sizeLessOne, step);
+  auto count = builder->create<mlir::LLVM::AddOp>(loc, lastIndex, constOne());
+  auto isEmpty =
+      builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::slt, size, constOne());
+  return builder->create<mlir::LLVM::SelectOp>(loc, isEmpty, constZero(), count);
+}
+
 mlir::Value Backend::strideArrayByScalar(std::shared_ptr<symTable::Type> type,
                                          mlir::Value arrayStruct, mlir::Value scalarValue) {
-  auto newSizeAddr = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), intTy(), constOne());
-  builder->create<mlir::LLVM::StoreOp>(loc, constZero(), newSizeAddr);
   auto arrayType = getMLIRType(type);
 
   auto arraySizeAddr = getArraySizeAddr(*builder, loc, arrayType, arrayStruct);
@@ -2013,16 +2215,7 @@ mlir::Value Backend::strideArrayByScalar(std::shared_ptr<symTable::Type> type,
   auto elementMLIRType = getMLIRType(elementType);
   auto elementArrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(elementType);
 
-  // for loop over array and skip by scalarValue to count how many elements we'll have
-  builder->create<mlir::scf::ForOp>(
-      loc, constZero(), arraySize, scalarValue, mlir::ValueRange{},
-      [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
-        auto newSize = b.create<mlir::LLVM::LoadOp>(l, intTy(), newSizeAddr);
-        auto incrementedSize = b.create<mlir::LLVM::AddOp>(l, newSize, constOne());
-        b.create<mlir::LLVM::StoreOp>(l, incrementedSize, newSizeAddr);
-        b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
-      });
-  auto newSize = builder->create<mlir::LLVM::LoadOp>(loc, intTy(), newSizeAddr);
+  auto newSize = getStridedCount(arraySize, scalarValue);
 
   auto newArrayStruct = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), arrayType, constOne());
 
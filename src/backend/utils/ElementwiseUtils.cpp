@@ -0,0 +1,416 @@
+#include "CompileTimeExceptions.h"
+#include "ast/expressions/BinaryAst.h"
+#include "ast/expressions/CastAst.h"
+#include "ast/expressions/CharLiteralAst.h"
+#include "ast/expressions/IntegerLiteralAst.h"
+#include "ast/expressions/UnaryAst.h"
+#include "ast/types/ArrayTypeAst.h"
+#include "symTable/ArrayTypeSymbol.h"
+#include "symTable/VectorTypeSymbol.h"
+
+#include <backend/Backend.h>
+
+namespace gazprea::backend {
+bool Backend::isElementwiseBinaryOp(ast::expressions::BinaryOpType op) const {
+  switch (op) {
+  case ast::expressions::BinaryOpType::ADD:
+  case ast::expressions::BinaryOpType::SUBTRACT:
+  case ast::expressions::BinaryOpType::MULTIPLY:
+  case ast::expressions::BinaryOpType::DIVIDE:
+  case ast::expressions::BinaryOpType::REM:
+  case ast::expressions::BinaryOpType::POWER:
+  case ast::expressions::BinaryOpType::LESS_THAN:
+  case ast::expressions::BinaryOpType::GREATER_THAN:
+  case ast::expressions::BinaryOpType::LESS_EQUAL:
+  case ast::expressions::BinaryOpType::GREATER_EQUAL:
+  case ast::expressions::BinaryOpType::AND:
+  case ast::expressions::BinaryOpType::OR:
+  case ast::expressions::BinaryOpType::XOR:
+    return true;
+  default:
+    // ==/!= compare whole arrays, ** is a dot product, || and by reshape
+    return false;
+  }
+}
+
+std::shared_ptr<symTable::Type>
+Backend::elementwiseElementType(const std::shared_ptr<symTable::Type> &type) {
+  if (isScalarType(type)) {
+    return type;
+  }
+  std::shared_ptr<symTable::Type> elementType;
+  if (auto arrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(type)) {
+    elementType = arrayType->getType();
+  } else if (auto vectorType = std::dynamic_pointer_cast<symTable::VectorTypeSymbol>(type)) {
+    elementType = vectorType->getType();
+  }
+  // Only 1D containers of scalars are handled, nested arrays take the generic path
+  return isScalarType(elementType) ? elementType : nullptr;
+}
+
+bool Backend::elementwiseOperandsCompatible(
+    ast::expressions::BinaryOpType op, const std::shared_ptr<symTable::Type> &resultElementType,
+    const std::shared_ptr<symTable::Type> &leftElementType,
+    const std::shared_ptr<symTable::Type> &rightElementType, bool &isReal) {
+  // The only promotion done here is integer -> real, anything else goes through castIfNeeded
+  isReal = isTypeReal(leftElementType) || isTypeReal(rightElementType) ||
+           isTypeReal(resultElementType);
+  auto isPromotable = [&](const std::shared_ptr<symTable::Type> &elementType) {
+    return isReal ? isTypeReal(elementType) || isTypeInteger(elementType)
+                  : elementType->getName() == leftElementType->getName();
+  };
+  if (!isPromotable(leftElementType) || !isPromotable(rightElementType)) {
+    return false;
+  }
+  const bool isComparison = op == ast::expressions::BinaryOpType::LESS_THAN ||
+                            op == ast::expressions::BinaryOpType::GREATER_THAN ||
+                            op == ast::expressions::BinaryOpType::LESS_EQUAL ||
+                            op == ast::expressions::BinaryOpType::GREATER_EQUAL;
+  const auto expectedResultName =
+      isComparison ? std::string("boolean") : (isReal ? "real" : leftElementType->getName());
+  return resultElementType->getName() == expectedResultName;
+}
+
+mlir::Value Backend::getContainerSizeAddr(const std::shared_ptr<symTable::Type> &type,
+                                          mlir::Value addr) {
+  if (isTypeVector(type)) {
+    return gepOpVector(getMLIRType(type), addr, VectorOffset::Size);
+  }
+  return getArraySizeAddr(*builder, loc, getMLIRType(type), addr);
+}
+
+mlir::Value Backend::getContainerDataAddr(const std::shared_ptr<symTable::Type> &type,
+                                          mlir::Value addr) {
+  if (isTypeVector(type)) {
+    return gepOpVector(getMLIRType(type), addr, VectorOffset::Data);
+  }
+  return getArrayDataAddr(*builder, loc, getMLIRType(type), addr);
+}
+
+mlir::Value Backend::createContainerStruct(const std::shared_ptr<symTable::Type> &type,
+                                           mlir::Value dataPtr, mlir::Value size) {
+  auto structTy = getMLIRType(type);
+  auto structAddr = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), structTy, constOne());
+  if (isTypeVector(type)) {
+    builder->create<mlir::LLVM::StoreOp>(loc, size,
+                                         gepOpVector(structTy, structAddr, VectorOffset::Size));
+    builder->create<mlir::LLVM::StoreOp>(
+        loc, size, gepOpVector(structTy, structAddr, VectorOffset::Capacity));
+    builder->create<mlir::LLVM::StoreOp>(loc, dataPtr,
+                                         gepOpVector(structTy, structAddr, VectorOffset::Data));
+    builder->create<mlir::LLVM::StoreOp>(loc, constFalse(),
+                                         gepOpVector(structTy, structAddr, VectorOffset::Is2D));
+  } else {
+    builder->create<mlir::LLVM::StoreOp>(loc, size,
+                                         getArraySizeAddr(*builder, loc, structTy, structAddr));
+    builder->create<mlir::LLVM::StoreOp>(loc, dataPtr,
+                                         getArrayDataAddr(*builder, loc, structTy, structAddr));
+    builder->create<mlir::LLVM::StoreOp>(loc, constFalse(),
+                                         get2DArrayBoolAddr(*builder, loc, structTy, structAddr));
+  }
+  return structAddr;
+}
+
+mlir::Value Backend::emitElementwiseBinary(ast::expressions::BinaryOpType op,
+                                           std::shared_ptr<symTable::Type> opType,
+                                           std::shared_ptr<symTable::Type> leftType,
+                                           std::shared_ptr<symTable::Type> rightType,
+                                           mlir::Value leftAddr, mlir::Value rightAddr) {
+  if (!isElementwiseBinaryOp(op) || isScalarType(opType)) {
+    return {};
+  }
+  auto resultElementType = elementwiseElementType(opType);
+  auto leftElementType = elementwiseElementType(leftType);
+  auto rightElementType = elementwiseElementType(rightType);
+  if (!resultElementType || !leftElementType || !rightElementType) {
+    return {};
+  }
+  const bool leftIsScalar = isScalarType(leftType);
+  const bool rightIsScalar = isScalarType(rightType);
+  if (leftIsScalar && rightIsScalar) {
+    return {};
+  }
+
+  bool isReal = false;
+  if (!elementwiseOperandsCompatible(op, resultElementType, leftElementType, rightElementType,
+                                     isReal)) {
+    return {};
+  }
+
+  // Scalars are loaded (and promoted) once, containers are read straight from their buffers
+  auto prepareOperand = [&](const std::shared_ptr<symTable::Type> &type,
+                            const std::shared_ptr<symTable::Type> &elementType, bool isScalar,
+                            mlir::Value addr) -> std::pair<mlir::Value, mlir::Value> {
+    if (isScalar) {
+      mlir::Value value = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(type), addr);
+      if (isReal && isTypeInteger(elementType)) {
+        value = builder->create<mlir::LLVM::SIToFPOp>(loc, floatTy(), value);
+      }
+      return {value, {}};
+    }
+    mlir::Value dataPtr =
+        builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), getContainerDataAddr(type, addr));
+    mlir::Value size =
+        builder->create<mlir::LLVM::LoadOp>(loc, intTy(), getContainerSizeAddr(type, addr));
+    return {dataPtr, size};
+  };
+  auto [leftValueOrData, leftSize] =
+      prepareOperand(leftType, leftElementType, leftIsScalar, leftAddr);
+  auto [rightValueOrData, rightSize] =
+      prepareOperand(rightType, rightElementType, rightIsScalar, rightAddr);
+
+  mlir::Value size = leftIsScalar ? rightSize : leftSize;
+  if (!leftIsScalar && !rightIsScalar) {
+    auto sizesNotEqual = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::ne,
+                                                             leftSize, rightSize);
+    const bool anyVector = isTypeVector(leftType) || isTypeVector(rightType);
+    builder->create<mlir::scf::IfOp>(loc, sizesNotEqual, [&](mlir::OpBuilder &b, mlir::Location l) {
+      auto throwFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(
+          anyVector ? kThrowVectorSizeErrorName : kThrowArraySizeErrorName);
+      b.create<mlir::LLVM::CallOp>(l, throwFunc, mlir::ValueRange{});
+      b.create<mlir::scf::YieldOp>(l);
+    });
+  }
+
+  auto resultElementMLIRType = getMLIRType(resultElementType);
+  mlir::Value resultDataPtr = mallocArray(resultElementMLIRType, size);
+
+  // One loop, no per-element temporaries: load, promote, compute, store
+  builder->create<mlir::scf::ForOp>(
+      loc, constZero(), size, constOne(), mlir::ValueRange{},
+      [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
+        auto loadElement = [&](const std::shared_ptr<symTable::Type> &elementType, bool isScalar,
+                               mlir::Value valueOrData) -> mlir::Value {
+          if (isScalar) {
+            return valueOrData;
+          }
+          auto elementPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), getMLIRType(elementType),
+                                                        valueOrData, mlir::ValueRange{i});
+          mlir::Value value = b.create<mlir::LLVM::LoadOp>(l, getMLIRType(elementType), elementPtr);
+          if (isReal && isTypeInteger(elementType)) {
+            value = b.create<mlir::LLVM::SIToFPOp>(l, floatTy(), value);
+          }
+          return value;
+        };
+        auto leftValue = loadElement(leftElementType, leftIsScalar, leftValueOrData);
+        auto rightValue = loadElement(rightElementType, rightIsScalar, rightValueOrData);
+        auto result = scalarBinaryValue(op, isReal, leftValue, rightValue);
+        auto resultPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), resultElementMLIRType,
+                                                     resultDataPtr, mlir::ValueRange{i});
+        b.create<mlir::LLVM::StoreOp>(l, result, resultPtr);
+        b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
+      });
+
+  return createContainerStruct(opType, resultDataPtr, size);
+}
+
+bool Backend::isFusableExpression(const std::shared_ptr<ast::expressions::ExpressionAst> &expr) {
+  if (auto binary = std::dynamic_pointer_cast<ast::expressions::BinaryAst>(expr)) {
+    auto opType = binary->getInferredSymbolType();
+    if (!opType || isScalarType(opType) || !isElementwiseBinaryOp(binary->getBinaryOpType())) {
+      return false;
+    }
+    auto leftType = binary->getLeft()->getInferredSymbolType();
+    auto rightType = binary->getRight()->getInferredSymbolType();
+    if (!leftType || !rightType) {
+      return false;
+    }
+    auto resultElementType = elementwiseElementType(opType);
+    auto leftElementType = elementwiseElementType(leftType);
+    auto rightElementType = elementwiseElementType(rightType);
+    bool isReal = false;
+    return resultElementType && leftElementType && rightElementType &&
+           elementwiseOperandsCompatible(binary->getBinaryOpType(), resultElementType,
+                                         leftElementType, rightElementType, isReal);
+  }
+  if (auto unary = std::dynamic_pointer_cast<ast::expressions::UnaryAst>(expr)) {
+    auto type = unary->getExpression()->getInferredSymbolType();
+    return type && !isScalarType(type) && elementwiseElementType(type);
+  }
+  if (auto cast = std::dynamic_pointer_cast<ast::expressions::CastAst>(expr)) {
+    auto fromType = cast->getExpression()->getInferredSymbolType();
+    auto toArray =
+        std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(cast->getResolvedTargetType());
+    if (!fromType || isScalarType(fromType) || !elementwiseElementType(fromType) || !toArray ||
+        !elementwiseElementType(toArray)) {
+      return false;
+    }
+    // A sized target pads or truncates the source, that stays with performArrayCast
+    auto arrayTypeAst = std::dynamic_pointer_cast<ast::types::ArrayTypeAst>(toArray->getDef());
+    if (!arrayTypeAst) {
+      return false;
+    }
+    for (const auto &size : arrayTypeAst->getSizes()) {
+      auto wildcard = std::dynamic_pointer_cast<ast::expressions::CharLiteralAst>(size);
+      if (!wildcard || wildcard->getValue() != '*') {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+std::vector<std::shared_ptr<ast::expressions::ExpressionAst>>
+Backend::getFusedChildren(const std::shared_ptr<ast::expressions::ExpressionAst> &expr) {
+  if (auto binary = std::dynamic_pointer_cast<ast::expressions::BinaryAst>(expr)) {
+    return {binary->getLeft(), binary->getRight()};
+  }
+  if (auto unary = std::dynamic_pointer_cast<ast::expressions::UnaryAst>(expr)) {
+    return {unary->getExpression()};
+  }
+  if (auto cast = std::dynamic_pointer_cast<ast::expressions::CastAst>(expr)) {
+    return {cast->getExpression()};
+  }
+  return {};
+}
+
+size_t Backend::countFusedNodes(const std::shared_ptr<ast::expressions::ExpressionAst> &expr) {
+  if (!isFusableExpression(expr)) {
+    return 0;
+  }
+  size_t count = 1;
+  for (const auto &child : getFusedChildren(expr)) {
+    count += countFusedNodes(child);
+  }
+  return count;
+}
+
+void Backend::collectFusedLeaves(
+    const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+    std::vector<std::shared_ptr<ast::expressions::ExpressionAst>> &leaves) {
+  if (!isFusableExpression(expr)) {
+    leaves.push_back(expr);
+    return;
+  }
+  for (const auto &child : getFusedChildren(expr)) {
+    collectFusedLeaves(child, leaves);
+  }
+}
+
+std::shared_ptr<symTable::Type>
+Backend::getFusedElementType(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                             const FusedLeafMap &leaves) {
+  if (auto leaf = leaves.find(expr.get()); leaf != leaves.end()) {
+    return leaf->second.elementType;
+  }
+  if (auto unary = std::dynamic_pointer_cast<ast::expressions::UnaryAst>(expr)) {
+    return getFusedElementType(unary->getExpression(), leaves);
+  }
+  if (auto cast = std::dynamic_pointer_cast<ast::expressions::CastAst>(expr)) {
+    return elementwiseElementType(cast->getResolvedTargetType());
+  }
+  return elementwiseElementType(expr->getInferredSymbolType());
+}
+
+mlir::Value Backend::emitFusedElement(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                                      const FusedLeafMap &leaves, mlir::Value index) {
+  if (auto leaf = leaves.find(expr.get()); leaf != leaves.end()) {
+    const auto &[type, elementType, isScalar, valueOrData, size] = leaf->second;
+    if (isScalar) {
+      return valueOrData;
+    }
+    auto elementPtr = builder->create<mlir::LLVM::GEPOp>(loc, ptrTy(), getMLIRType(elementType),
+                                                         valueOrData, mlir::ValueRange{index});
+    return builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(elementType), elementPtr);
+  }
+
+  if (auto binary = std::dynamic_pointer_cast<ast::expressions::BinaryAst>(expr)) {
+    auto leftElementType = getFusedElementType(binary->getLeft(), leaves);
+    auto rightElementType = getFusedElementType(binary->getRight(), leaves);
+    bool isReal = false;
+    elementwiseOperandsCompatible(binary->getBinaryOpType(), getFusedElementType(binary, leaves),
+                                  leftElementType, rightElementType, isReal);
+    mlir::Value leftValue = emitFusedElement(binary->getLeft(), leaves, index);
+    mlir::Value rightValue = emitFusedElement(binary->getRight(), leaves, index);
+    if (isReal && isTypeInteger(leftElementType)) {
+      leftValue = builder->create<mlir::LLVM::SIToFPOp>(loc, floatTy(), leftValue);
+    }
+    if (isReal && isTypeInteger(rightElementType)) {
+      rightValue = builder->create<mlir::LLVM::SIToFPOp>(loc, floatTy(), rightValue);
+    }
+    return scalarBinaryValue(binary->getBinaryOpType(), isReal, leftValue, rightValue);
+  }
+
+  if (auto unary = std::dynamic_pointer_cast<ast::expressions::UnaryAst>(expr)) {
+    auto value = emitFusedElement(unary->getExpression(), leaves, index);
+    return applyUnaryToScalar(unary->getUnaryOpType(), getFusedElementType(unary, leaves),
+                              *builder, loc, value);
+  }
+
+  auto cast = std::dynamic_pointer_cast<ast::expressions::CastAst>(expr);
+  auto value = emitFusedElement(cast->getExpression(), leaves, index);
+  return promoteScalarValue(value, getFusedElementType(cast->getExpression(), leaves),
+                            getFusedElementType(cast, leaves));
+}
+
+bool Backend::tryEmitFusedExpression(const std::shared_ptr<ast::expressions::ExpressionAst> &root) {
+  // A single op is already one loop through emitElementwiseBinary, fusing pays off from two up
+  if (countFusedNodes(root) < 2) {
+    return false;
+  }
+
+  std::vector<std::shared_ptr<ast::expressions::ExpressionAst>> leaves;
+  collectFusedLeaves(root, leaves);
+
+  // Leaves are evaluated once each, left to right, exactly as the unfused visit would. Kept local
+  // since a leaf (e.g. a call argument) can itself contain a fused expression.
+  FusedLeafMap fusedLeaves;
+  mlir::Value size;
+  for (const auto &leaf : leaves) {
+    visit(leaf);
+    auto [type, addr] = popElementFromStack(root);
+    FusedLeaf fusedLeaf{type, elementwiseElementType(type), isScalarType(type), {}, {}};
+    if (auto literal = std::dynamic_pointer_cast<ast::expressions::IntegerLiteralAst>(leaf)) {
+      // Known to emitPower, so e.g. `v ^ 2` becomes a multiply in the loop
+      fusedLeaf.valueOrData =
+          builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), literal->integerValue);
+    } else if (fusedLeaf.isScalar) {
+      fusedLeaf.valueOrData = builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(type), addr);
+    } else {
+      fusedLeaf.valueOrData =
+          builder->create<mlir::LLVM::LoadOp>(loc, ptrTy(), getContainerDataAddr(type, addr));
+      fusedLeaf.size =
+          builder->create<mlir::LLVM::LoadOp>(loc, intTy(), getContainerSizeAddr(type, addr));
+      if (!size) {
+        size = fusedLeaf.size;
+      } else {
+        auto sizesNotEqual = builder->create<mlir::LLVM::ICmpOp>(
+            loc, mlir::LLVM::ICmpPredicate::ne, size, fusedLeaf.size);
+        auto throwName = isTypeVector(type) ? kThrowVectorSizeErrorName : kThrowArraySizeErrorName;
+        builder->create<mlir::scf::IfOp>(
+            loc, sizesNotEqual, [&](mlir::OpBuilder &b, mlir::Location l) {
+              auto throwFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(throwName);
+              b.create<mlir::LLVM::CallOp>(l, throwFunc, mlir::ValueRange{});
+              b.create<mlir::scf::YieldOp>(l);
+            });
+      }
+    }
+    fusedLeaves[leaf.get()] = fusedLeaf;
+  }
+
+  auto resultType = root->getInferredSymbolType();
+  if (auto unary = std::dynamic_pointer_cast<ast::expressions::UnaryAst>(root)) {
+    resultType = unary->getExpression()->getInferredSymbolType();
+  } else if (auto cast = std::dynamic_pointer_cast<ast::expressions::CastAst>(root)) {
+    resultType = cast->getResolvedTargetType();
+  }
+  auto resultElementMLIRType = getMLIRType(getFusedElementType(root, fusedLeaves));
+  mlir::Value resultDataPtr = mallocArray(resultElementMLIRType, size);
+
+  // The whole tree becomes one loop writing straight into the final buffer
+  builder->create<mlir::scf::ForOp>(
+      loc, constZero(), size, constOne(), mlir::ValueRange{},
+      [&](mlir::OpBuilder &b, mlir::Location l, mlir::Value i, mlir::ValueRange iterArgs) {
+        auto result = emitFusedElement(root, fusedLeaves, i);
+        auto resultPtr = b.create<mlir::LLVM::GEPOp>(l, ptrTy(), resultElementMLIRType,
+                                                     resultDataPtr, mlir::ValueRange{i});
+        b.create<mlir::LLVM::StoreOp>(l, result, resultPtr);
+        b.create<mlir::scf::YieldOp>(l, mlir::ValueRange{});
+      });
+
+  pushElementToScopeStack(root, resultType, createContainerStruct(resultType, resultDataPtr, size));
+  return true;
+}
+
+} // namespace gazprea::backend
@@ -0,0 +1,96 @@
+#include "symTable/ArrayTypeSymbol.h"
+
+#include <backend/Backend.h>
+
+namespace gazprea::backend {
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateDotFunc(bool isReal) {
+  const char *name = isReal ? kDotRealName : kDotIntName;
+  auto dotFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(name);
+  if (dotFunc) {
+    return dotFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: element dot(ptr left, ptr right, i32 size)
+  auto elementTy = isReal ? floatTy() : intTy();
+  auto dotFnType = mlir::LLVM::LLVMFunctionType::get(elementTy, {ptrTy(), ptrTy(), intTy()},
+                                                     /*isVarArg=*/false);
+  dotFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, name, dotFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return dotFunc;
+}
+
+mlir::LLVM::LLVMFuncOp Backend::getOrCreateRowDotsFunc(bool isReal) {
+  const char *name = isReal ? kRowDotsRealName : kRowDotsIntName;
+  auto rowDotsFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(name);
+  if (rowDotsFunc) {
+    return rowDotsFunc;
+  }
+  auto savedInsertionPoint = builder->saveInsertionPoint();
+  builder->setInsertionPointToStart(module.getBody());
+  // Signature: void rowDots(ptr leftStruct, ptr rightStruct, ptr result, i32 rows)
+  auto voidType = mlir::LLVM::LLVMVoidType::get(builder->getContext());
+  auto rowDotsFnType = mlir::LLVM::LLVMFunctionType::get(
+      voidType, {ptrTy(), ptrTy(), ptrTy(), intTy()}, /*isVarArg=*/false);
+  rowDotsFunc = builder->create<mlir::LLVM::LLVMFuncOp>(loc, name, rowDotsFnType);
+  builder->restoreInsertionPoint(savedInsertionPoint);
+  return rowDotsFunc;
+}
+
+// `**` on integer or real arrays goes to the runtime dot kernels: a scalar for 1D operands and one
+// dot per row pair for 2D operands. The operands must already share their element type and outer
+// size. Returns a null value when the operands are not plain numeric arrays.
+mlir::Value Backend::emitDotKernel(std::shared_ptr<symTable::Type> opType,
+                                   std::shared_ptr<symTable::Type> leftType,
+                                   std::shared_ptr<symTable::Type> rightType, mlir::Value leftAddr,
+                                   mlir::Value rightAddr) {
+  if (!runtimeKernels) {
+    return {};
+  }
+  auto leftArrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(leftType);
+  auto rightArrayType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(rightType);
+  if (!leftArrayType || !rightArrayType) {
+    return {};
+  }
+  auto leftElementType = leftArrayType->getType();
+  auto rightElementType = rightArrayType->getType();
+  auto leftRowType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(leftElementType);
+  auto rightRowType = std::dynamic_pointer_cast<symTable::ArrayTypeSymbol>(rightElementType);
+  if (static_cast<bool>(leftRowType) != static_cast<bool>(rightRowType)) {
+    return {};
+  }
+  if (leftRowType) {
+    leftElementType = leftRowType->getType();
+    rightElementType = rightRowType->getType();
+  }
+  if (!isScalarType(leftElementType) || !isScalarType(rightElementType) ||
+      leftElementType->getName() != rightElementType->getName()) {
+    return {};
+  }
+  const bool isReal = leftElementType->getName() == "real";
+  if (!isReal && leftElementType->getName() != "integer") {
+    return {};
+  }
+
+  auto size = builder->create<mlir::LLVM::LoadOp>(
+      loc, intTy(), getArraySizeAddr(*builder, loc, getMLIRType(rightType), rightAddr));
+  if (!leftRowType) {
+    auto leftDataPtr = builder->create<mlir::LLVM::LoadOp>(
+        loc, ptrTy(), getArrayDataAddr(*builder, loc, getMLIRType(leftType), leftAddr));
+    auto rightDataPtr = builder->create<mlir::LLVM::LoadOp>(
+        loc, ptrTy(), getArrayDataAddr(*builder, loc, getMLIRType(rightType), rightAddr));
+    auto dot = builder->create<mlir::LLVM::CallOp>(
+        loc, getOrCreateDotFunc(isReal), mlir::ValueRange{leftDataPtr, rightDataPtr, size});
+    auto resultAddr =
+        builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(opType), constOne());
+    builder->create<mlir::LLVM::StoreOp>(loc, dot.getResult(), resultAddr);
+    return resultAddr;
+  }
+
+  auto resultDataPtr = mallocArray(getMLIRType(leftElementType), size);
+  builder->create<mlir::LLVM::CallOp>(loc, getOrCreateRowDotsFunc(isReal),
+                                      mlir::ValueRange{leftAddr, rightAddr, resultDataPtr, size});
+  return createContainerStruct(opType, resultDataPtr, size);
+}
+
+} // namespace gazprea::backend
@@ -0,0 +1,115 @@
+#include "ast/expressions/BinaryAst.h"
+#include "ast/expressions/IntegerLiteralAst.h"
+
+#include <backend/Backend.h>
+
+namespace gazprea::backend {
+mlir::Value Backend::powerOperandToValue(std::shared_ptr<ast::Ast> ctx,
+                                         std::shared_ptr<symTable::Type> opType,
+                                         std::shared_ptr<symTable::Type> leftType,
+                                         std::shared_ptr<symTable::Type> rightType,
+                                         mlir::Value leftAddr, mlir::Value rightAddr) {
+  const bool isReal = isTypeReal(leftType) || isTypeReal(rightType);
+  auto binary = std::dynamic_pointer_cast<ast::expressions::BinaryAst>(ctx);
+  // Integer literals become constants so the power can be specialized on them
+  auto loadOperand = [&](const std::shared_ptr<ast::expressions::ExpressionAst> &operand,
+                         const std::shared_ptr<symTable::Type> &type,
+                         mlir::Value addr) -> mlir::Value {
+    auto literal = std::dynamic_pointer_cast<ast::expressions::IntegerLiteralAst>(operand);
+    if (literal && isTypeInteger(type)) {
+      return builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), literal->integerValue);
+    }
+    return builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(type), addr);
+  };
+  mlir::Value base = loadOperand(binary ? binary->getLeft() : nullptr, leftType, leftAddr);
+  mlir::Value exponent = loadOperand(binary ? binary->getRight() : nullptr, rightType, rightAddr);
+  if (isReal && isTypeInteger(leftType)) {
+    base = builder->create<mlir::LLVM::SIToFPOp>(loc, floatTy(), base);
+  }
+  if (isReal && isTypeInteger(rightType)) {
+    exponent = builder->create<mlir::LLVM::SIToFPOp>(loc, floatTy(), exponent);
+  }
+
+  auto newAddr =
+      builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(opType), constOne());
+  builder->create<mlir::LLVM::StoreOp>(loc, emitPower(isReal, base, exponent), newAddr);
+  return newAddr;
+}
+
+mlir::Value Backend::emitPower(bool isReal, mlir::Value base, mlir::Value exponent) {
+  if (isReal) {
+    // A promoted integer exponent goes to powi, which LLVM expands into multiplies when it is a
+    // constant and which vectorizes inside element loops
+    if (auto promoted = exponent.getDefiningOp<mlir::LLVM::SIToFPOp>()) {
+      return builder->create<mlir::LLVM::PowIOp>(loc, floatTy(), base, promoted.getArg());
+    }
+    return builder->create<mlir::LLVM::PowOp>(loc, base, exponent);
+  }
+
+  if (auto constant = getIntConstant(exponent)) {
+    return emitConstantIntPower(base, *constant);
+  }
+  if (auto constant = getIntConstant(base)) {
+    // Bases whose powers have a closed form; a non-positive exponent always gives 1
+    auto one = constOne();
+    auto isPositive = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::sgt,
+                                                          exponent, constZero());
+    switch (*constant) {
+    case 0:
+      return builder->create<mlir::LLVM::SelectOp>(loc, isPositive, constZero(), one);
+    case 1:
+      return one;
+    case -1: {
+      auto isOdd = builder->create<mlir::LLVM::TruncOp>(loc, boolTy(), exponent);
+      auto isNegative = builder->create<mlir::LLVM::AndOp>(loc, isPositive, isOdd);
+      auto minusOne = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), -1);
+      return builder->create<mlir::LLVM::SelectOp>(loc, isNegative, minusOne, one);
+    }
+    case 2: {
+      // 2^31 wraps to INT_MIN and every larger power to 0, like the repeated product
+      auto bitWidth = builder->create<mlir::LLVM::ConstantOp>(loc, intTy(), 32);
+      auto overflows = builder->create<mlir::LLVM::ICmpOp>(loc, mlir::LLVM::ICmpPredicate::sge,
+                                                           exponent, bitWidth);
+      auto shifted = builder->create<mlir::LLVM::ShlOp>(loc, one, exponent);
+      auto power = builder->create<mlir::LLVM::SelectOp>(loc, overflows, constZero(), shifted);
+      return builder->create<mlir::LLVM::SelectOp>(loc, isPositive, power, one);
+    }
+    default:
+      break;
+    }
+  }
+
+  auto ipowFunc = module.lookupSymbol<mlir::LLVM::LLVMFuncOp>(kIpowName);
+  return builder->create<mlir::LLVM::CallOp>(loc, ipowFunc, mlir::ValueRange{base, exponent})
+      .getResult();
+}
+
+// Square-and-multiply unrolled for a known exponent, e.g. x^2 -> x*x and x^5 -> (x*x)^2*x
+mlir::Value Backend::emitConstantIntPower(mlir::Value base, int64_t exponent) {
+  if (exponent <= 0) {
+    return constOne();
+  }
+  mlir::Value result;
+  mlir::Value square = base;
+  for (uint64_t remaining = exponent;;) {
+    if (remaining & 1) {
+      result = result ? builder->create<mlir::LLVM::MulOp>(loc, result, square).getResult()
+                      : square;
+    }
+    remaining >>= 1;
+    if (!remaining) {
+      return result;
+    }
+    square = builder->create<mlir::LLVM::MulOp>(loc, square, square);
+  }
+}
+
+std::optional<int64_t> Backend::getIntConstant(mlir::Value value) {
+  if (auto constant = value.getDefiningOp<mlir::LLVM::ConstantOp>()) {
+    if (auto intAttr = mlir::dyn_cast<mlir::IntegerAttr>(constant.getValue())) {
+      return intAttr.getValue().getSExtValue();
+    }
+  }
+  return std::nullopt;
+}
+} // namespace gazprea::backend
@@ -0,0 +1,141 @@
+#include "ast/prototypes/FunctionParamAst.h"
+#include "ast/prototypes/ProcedureParamAst.h"
+#include "symTable/MethodSymbol.h"
+
+#include <backend/Backend.h>
+
+namespace gazprea::backend {
+
+namespace {
+std::shared_ptr<ast::expressions::FuncProcCallAst>
+asFuncProcCall(const std::shared_ptr<ast::expressions::ExpressionAst> &expr) {
+  if (const auto router =
+          std::dynamic_pointer_cast<ast::expressions::StructFuncCallRouterAst>(expr)) {
+    return router->getIsStruct() ? nullptr : router->getFuncProcCallAst();
+  }
+  return std::dynamic_pointer_cast<ast::expressions::FuncProcCallAst>(expr);
+}
+
+std::string paramName(const std::shared_ptr<ast::Ast> &param) {
+  if (const auto funcParam = std::dynamic_pointer_cast<ast::prototypes::FunctionParamAst>(param)) {
+    return funcParam->getName();
+  }
+  return std::dynamic_pointer_cast<ast::prototypes::ProcedureParamAst>(param)->getName();
+}
+
+// Records every call to `self` after which the body does nothing but return its result: a
+// `return self(...)`, or a `call self(...)` that ends the body or is directly followed by `return;`
+void collectSelfTailCalls(const std::shared_ptr<ast::Ast> &statement,
+                          const symTable::Symbol *self, bool endsBody,
+                          std::unordered_set<const ast::Ast *> &sites) {
+  if (!statement) {
+    return;
+  }
+  if (const auto block = std::dynamic_pointer_cast<ast::statements::BlockAst>(statement)) {
+    const auto &children = block->getChildren();
+    for (size_t i = 0; i < children.size(); ++i) {
+      const bool isLast = i + 1 == children.size();
+      bool followedByReturn = false;
+      if (!isLast) {
+        const auto next = std::dynamic_pointer_cast<ast::statements::ReturnAst>(children[i + 1]);
+        followedByReturn = next && !next->getExpr();
+      }
+      collectSelfTailCalls(children[i], self, (endsBody && isLast) || followedByReturn, sites);
+    }
+  } else if (const auto returnAst =
+                 std::dynamic_pointer_cast<ast::statements::ReturnAst>(statement)) {
+    const auto call = asFuncProcCall(returnAst->getExpr());
+    if (call && call->getSymbol().get() == self) {
+      sites.insert(returnAst.get());
+    }
+  } else if (const auto procCall =
+                 std::dynamic_pointer_cast<ast::statements::ProcedureCallAst>(statement)) {
+    if (endsBody && procCall->getSymbol().get() == self) {
+      sites.insert(procCall.get());
+    }
+  } else if (const auto conditional =
+                 std::dynamic_pointer_cast<ast::statements::ConditionalAst>(statement)) {
+    collectSelfTailCalls(conditional->getThenBody(), self, endsBody, sites);
+    collectSelfTailCalls(conditional->getElseBody(), self, endsBody, sites);
+  } else if (const auto loop = std::dynamic_pointer_cast<ast::statements::LoopAst>(statement)) {
+    collectSelfTailCalls(loop->getBody(), self, false, sites);
+  } else if (const auto iteratorLoop =
+                 std::dynamic_pointer_cast<ast::statements::IteratorLoopAst>(statement)) {
+    collectSelfTailCalls(iteratorLoop->getBody(), self, false, sites);
+  }
+}
+} // namespace
+
+void Backend::beginTailCallLoop(const std::shared_ptr<ast::prototypes::PrototypeAst> &proto,
+                                const std::shared_ptr<ast::statements::StatementAst> &body) {
+  tailCallLoop.reset();
+  const auto methodSym = std::dynamic_pointer_cast<symTable::MethodSymbol>(proto->getSymbol());
+  const auto &params = proto->getParams();
+  for (const auto &param : params) {
+    const auto paramSym = std::dynamic_pointer_cast<symTable::VariableSymbol>(param->getSymbol());
+    if (!paramSym || paramSym->getQualifier() != ast::Qualifier::Const ||
+        !isScalarType(paramSym->getType())) {
+      return;
+    }
+  }
+  TailCallLoop loop;
+  collectSelfTailCalls(body, methodSym.get(), true, loop.sites);
+  if (loop.sites.empty()) {
+    return;
+  }
+
+  // Each param gets a slot of its own so the next iteration's arguments can be stored into it
+  loop.params = params;
+  for (const auto &param : params) {
+    const auto paramSym = std::dynamic_pointer_cast<symTable::VariableSymbol>(param->getSymbol());
+    const auto paramType = getMLIRType(paramSym->getType());
+    const auto name = paramName(param);
+    auto slot = builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), paramType, constOne());
+    auto argValue = builder->create<mlir::LLVM::LoadOp>(loc, paramType, blockArg[name]);
+    builder->create<mlir::LLVM::StoreOp>(loc, argValue, slot);
+    blockArg[name] = slot;
+    paramSym->value = slot;
+    loop.paramSlots.push_back(slot);
+  }
+
+  // Codegen allocates temporaries as it goes; restoring the stack on every iteration releases the
+  // previous iteration's, so the loop runs in the constant stack the recursion could not
+  loop.stackPtr = builder->create<mlir::LLVM::StackSaveOp>(loc, ptrTy());
+  loop.headerBlock = new mlir::Block();
+  builder->getInsertionBlock()->getParent()->push_back(loop.headerBlock);
+  builder->create<mlir::cf::BranchOp>(loc, loop.headerBlock);
+  builder->setInsertionPointToStart(loop.headerBlock);
+  builder->create<mlir::LLVM::StackRestoreOp>(loc, loop.stackPtr);
+  tailCallLoop = std::move(loop);
+}
+
+bool Backend::emitSelfTailCall(const std::shared_ptr<ast::Ast> &site,
+                               const std::vector<std::shared_ptr<ast::expressions::ArgAst>> &args) {
+  if (!tailCallLoop || !tailCallLoop->sites.count(site.get())) {
+    return false;
+  }
+  // Every argument is computed before any slot is overwritten, since they may read the params
+  std::vector<mlir::Value> argValues;
+  for (size_t i = 0; i < args.size(); ++i) {
+    visit(args[i]);
+    auto [valueType, valueAddr] = popElementFromStack(args[i]);
+    const auto &param = tailCallLoop->params[i];
+    const auto paramSym = std::dynamic_pointer_cast<symTable::VariableSymbol>(param->getSymbol());
+    if (valueType->getName() != paramSym->getType()->getName()) {
+      // Casts happen in place, so convert a copy rather than a variable the body may still read
+      auto argCopy =
+          builder->create<mlir::LLVM::AllocaOp>(loc, ptrTy(), getMLIRType(valueType), constOne());
+      copyValue(valueType, valueAddr, argCopy);
+      valueAddr = castIfNeeded(param, argCopy, valueType, paramSym->getType());
+    }
+    argValues.push_back(
+        builder->create<mlir::LLVM::LoadOp>(loc, getMLIRType(paramSym->getType()), valueAddr));
+  }
+  for (size_t i = 0; i < argValues.size(); ++i) {
+    builder->create<mlir::LLVM::StoreOp>(loc, argValues[i], tailCallLoop->paramSlots[i]);
+  }
+  builder->create<mlir::cf::BranchOp>(loc, tailCallLoop->headerBlock);
+  return true;
+}
+
+} // namespace gazprea::backend
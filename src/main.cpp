@@ -6,22 +6,69 @@
 #include "GazpreaParser.h"
 #include "ast/RootAst.h"
 #include "ast/walkers/AstBuilder.h"
+#include "ast/walkers/ConstantFoldingWalker.h"
 #include "ast/walkers/DefRefWalker.h"
 #include "ast/walkers/ValidationWalker.h"
 #include "tree/ParseTree.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 
 int main(int argc, char **argv) {
-  if (argc < 3) {
+  // Flags may appear anywhere, everything else is positional.
+  unsigned optLevel = 0;
+  std::string emit = "llvm";
+  bool passReport = false;
+  bool runtimeKernels = true;
+  bool memoizeFunctions = false;
+  // libgazrt is symlinked next to gazc in bin/ by default
+  std::string runtimeDir = llvm::sys::path::parent_path(argv[0]).str();
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.size() == 3 && arg[0] == '-' && arg[1] == 'O' && arg[2] >= '0' && arg[2] <= '3') {
+      optLevel = arg[2] - '0';
+    } else if (arg.rfind("--emit=", 0) == 0) {
+      emit = arg.substr(7);
+    } else if (arg == "--pass-report") {
+      passReport = true;
+    } else if (arg == "--no-rt-kernels") {
+      runtimeKernels = false;
+    } else if (arg == "--memoize-functions") {
+      memoizeFunctions = true;
+    } else if (arg == "--run") {
+      emit = "run";
+    } else if (arg.rfind("--rt-path=", 0) == 0) {
+      runtimeDir = arg.substr(10);
+    } else {
+      positional.push_back(arg);
+    }
+  }
+  if (runtimeDir.empty()) {
+    runtimeDir = ".";
+  }
+
+  // --run executes the program in-process and writes no output file
+  if (positional.size() < (emit == "run" ? 1u : 2u)) {
     std::cout << "Missing required argument.\n"
-              << "Required arguments: <input file path> <output file path>\n";
+              << "Required arguments: [-O0|-O1|-O2|-O3] [--emit=llvm|obj|exe] [--rt-path=<dir>] "
+                 "[--pass-report] [--no-rt-kernels] [--memoize-functions] "
+                 "<input file path> <output file path>\n"
+              << "                or: [-O0|-O1|-O2|-O3] [--rt-path=<dir>] --run <input file path>\n";
+    return 1;
+  }
+  if (emit != "llvm" && emit != "obj" && emit != "exe" && emit != "run") {
+    std::cout << "Unknown emit mode: " << emit << "\n"
+              << "Expected one of: llvm, obj, exe, run\n";
     return 1;
   }
 
   // Open the file then parse and lex it.
   antlr4::ANTLRFileStream afs;
-  afs.loadFromFile(argv[1]);
+  afs.loadFromFile(positional[0]);
   gazprea::GazpreaLexer lexer(&afs);
   antlr4::CommonTokenStream tokens(&lexer);
 
@@ -46,13 +93,38 @@ int main(int argc, char **argv) {
     gazprea::ast::walkers::ValidationWalker validationWalker(symTab);
     validationWalker.visit(rootAst);
 
+    gazprea::ast::walkers::ConstantFoldingWalker constantFoldingWalker(symTab);
+    constantFoldingWalker.visit(rootAst);
+
     // std::cout << rootAst->toStringTree("") << std::endl;
 
-    std::ofstream os(argv[2]);
-    gazprea::backend::Backend backend(rootAst);
+    gazprea::backend::Backend backend(rootAst, optLevel);
+    backend.setPassReport(passReport);
+    backend.setRuntimeKernels(runtimeKernels);
+    backend.setMemoizeFunctions(memoizeFunctions);
     backend.emitModule();
     backend.lowerDialects();
-    backend.dumpLLVM(os);
+
+    if (emit == "llvm") {
+      std::ofstream os(positional[1]);
+      backend.dumpLLVM(os);
+    } else if (emit == "run") {
+      int exitCode = 0;
+      if (backend.runJIT(runtimeDir, exitCode)) {
+        return 1;
+      }
+      return exitCode;
+    } else if (emit == "obj") {
+      return backend.emitObject(positional[1]);
+    } else {
+      const std::string objectPath = positional[1] + ".o";
+      int status = backend.emitObject(objectPath);
+      if (!status) {
+        status = backend.linkExecutable(objectPath, positional[1], runtimeDir);
+      }
+      llvm::sys::fs::remove(objectPath);
+      return status;
+    }
   } catch (const std::exception &e) {
     std::cerr << e.what();
     return 1;
@@ -0,0 +1,347 @@
+#include "utils/ConstantFoldingUtils.h"
+#include "ast/expressions/BoolLiteralAst.h"
+#include "ast/expressions/CharLiteralAst.h"
+#include "ast/expressions/IntegerLiteralAst.h"
+#include "ast/expressions/RealLiteralAst.h"
+#include "ast/types/BooleanTypeAst.h"
+#include "ast/types/CharacterTypeAst.h"
+#include "ast/types/IntegerTypeAst.h"
+#include "ast/types/RealTypeAst.h"
+
+#include <cmath>
+#include <limits>
+
+namespace gazprea::utils {
+
+namespace {
+// Integer arithmetic wraps like the i32 ops the backend emits
+int32_t wrap(const int64_t value) {
+  return static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(value)));
+}
+
+// Same results as the runtime ipow: non-positive exponents give 1
+int32_t intPower(const int32_t base, const int32_t exponent) {
+  if (exponent <= 0)
+    return 1;
+  uint32_t result = 1;
+  uint32_t factor = static_cast<uint32_t>(base);
+  for (uint32_t e = static_cast<uint32_t>(exponent); e; e >>= 1) {
+    if (e & 1u)
+      result *= factor;
+    factor *= factor;
+  }
+  return static_cast<int32_t>(result);
+}
+
+// Same results as llvm.powi.f32, which the backend uses for a real base and an integer exponent
+float realIntPower(float base, const int32_t exponent) {
+  const bool reciprocal = exponent < 0;
+  int32_t e = exponent;
+  float result = 1.0f;
+  while (true) {
+    if (e & 1)
+      result *= base;
+    e /= 2;
+    if (e == 0)
+      break;
+    base *= base;
+  }
+  return reciprocal ? 1.0f / result : result;
+}
+
+std::optional<ConstantValue> foldComparison(const ast::expressions::BinaryOpType op,
+                                            const float left, const float right) {
+  const bool ordered = !std::isnan(left) && !std::isnan(right);
+  switch (op) {
+  case ast::expressions::BinaryOpType::EQUAL:
+    return makeBoolConstant(left == right);
+  case ast::expressions::BinaryOpType::NOT_EQUAL:
+    return makeBoolConstant(ordered && left != right);
+  case ast::expressions::BinaryOpType::LESS_THAN:
+    return makeBoolConstant(left < right);
+  case ast::expressions::BinaryOpType::GREATER_THAN:
+    return makeBoolConstant(left > right);
+  case ast::expressions::BinaryOpType::LESS_EQUAL:
+    return makeBoolConstant(left <= right);
+  case ast::expressions::BinaryOpType::GREATER_EQUAL:
+    return makeBoolConstant(left >= right);
+  default:
+    return std::nullopt;
+  }
+}
+} // namespace
+
+std::string constantKindName(const ConstantKind kind) {
+  switch (kind) {
+  case ConstantKind::Integer:
+    return "integer";
+  case ConstantKind::Real:
+    return "real";
+  case ConstantKind::Character:
+    return "character";
+  case ConstantKind::Boolean:
+    return "boolean";
+  }
+  return "";
+}
+
+bool isScalarTypeName(const std::string &typeName) {
+  return typeName == "integer" || typeName == "real" || typeName == "character" ||
+         typeName == "boolean";
+}
+
+ConstantValue makeIntConstant(const int32_t value) {
+  ConstantValue constant{ConstantKind::Integer};
+  constant.intValue = value;
+  return constant;
+}
+ConstantValue makeRealConstant(const float value) {
+  ConstantValue constant{ConstantKind::Real};
+  constant.realValue = value;
+  return constant;
+}
+ConstantValue makeCharConstant(const char value) {
+  ConstantValue constant{ConstantKind::Character};
+  constant.charValue = value;
+  return constant;
+}
+ConstantValue makeBoolConstant(const bool value) {
+  ConstantValue constant{ConstantKind::Boolean};
+  constant.boolValue = value;
+  return constant;
+}
+
+std::optional<ConstantValue> zeroConstant(const std::string &typeName) {
+  if (typeName == "integer")
+    return makeIntConstant(0);
+  if (typeName == "real")
+    return makeRealConstant(0.0f);
+  if (typeName == "character")
+    return makeCharConstant(0);
+  if (typeName == "boolean")
+    return makeBoolConstant(false);
+  return std::nullopt;
+}
+
+std::optional<ConstantValue>
+literalValue(const std::shared_ptr<ast::expressions::ExpressionAst> &expr) {
+  if (!expr)
+    return std::nullopt;
+  switch (expr->getNodeType()) {
+  case ast::NodeType::IntegerLiteral:
+    return makeIntConstant(
+        std::static_pointer_cast<ast::expressions::IntegerLiteralAst>(expr)->integerValue);
+  case ast::NodeType::RealLiteral:
+    return makeRealConstant(
+        std::static_pointer_cast<ast::expressions::RealLiteralAst>(expr)->realValue);
+  case ast::NodeType::CharLiteral:
+    return makeCharConstant(
+        std::static_pointer_cast<ast::expressions::CharLiteralAst>(expr)->getValue());
+  case ast::NodeType::BoolLiteral:
+    return makeBoolConstant(
+        std::static_pointer_cast<ast::expressions::BoolLiteralAst>(expr)->getValue());
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<ConstantValue> foldBinary(const ast::expressions::BinaryOpType op,
+                                        const ConstantValue &left, const ConstantValue &right) {
+  using ast::expressions::BinaryOpType;
+  if (left.kind == ConstantKind::Integer && right.kind == ConstantKind::Integer) {
+    const int64_t l = left.intValue;
+    const int64_t r = right.intValue;
+    switch (op) {
+    case BinaryOpType::ADD:
+      return makeIntConstant(wrap(l + r));
+    case BinaryOpType::SUBTRACT:
+      return makeIntConstant(wrap(l - r));
+    case BinaryOpType::MULTIPLY:
+      return makeIntConstant(wrap(l * r));
+    case BinaryOpType::DIVIDE:
+    case BinaryOpType::REM:
+      // Division by zero has to raise at runtime and INT_MIN / -1 traps there as well
+      if (r == 0 || (l == std::numeric_limits<int32_t>::min() && r == -1))
+        return std::nullopt;
+      return makeIntConstant(static_cast<int32_t>(op == BinaryOpType::DIVIDE ? l / r : l % r));
+    case BinaryOpType::POWER:
+      return makeIntConstant(intPower(left.intValue, right.intValue));
+    case BinaryOpType::EQUAL:
+      return makeBoolConstant(l == r);
+    case BinaryOpType::NOT_EQUAL:
+      return makeBoolConstant(l != r);
+    case BinaryOpType::LESS_THAN:
+      return makeBoolConstant(l < r);
+    case BinaryOpType::GREATER_THAN:
+      return makeBoolConstant(l > r);
+    case BinaryOpType::LESS_EQUAL:
+      return makeBoolConstant(l <= r);
+    case BinaryOpType::GREATER_EQUAL:
+      return makeBoolConstant(l >= r);
+    default:
+      return std::nullopt;
+    }
+  }
+
+  const auto isNumeric = [](const ConstantValue &value) {
+    return value.kind == ConstantKind::Integer || value.kind == ConstantKind::Real;
+  };
+  if (isNumeric(left) && isNumeric(right)) {
+    const auto toReal = [](const ConstantValue &value) {
+      return value.kind == ConstantKind::Real ? value.realValue
+                                              : static_cast<float>(value.intValue);
+    };
+    const float l = toReal(left);
+    const float r = toReal(right);
+    switch (op) {
+    case BinaryOpType::ADD:
+      return makeRealConstant(l + r);
+    case BinaryOpType::SUBTRACT:
+      return makeRealConstant(l - r);
+    case BinaryOpType::MULTIPLY:
+      return makeRealConstant(l * r);
+    case BinaryOpType::DIVIDE:
+      if (r == 0.0f)
+        return std::nullopt;
+      return makeRealConstant(l / r);
+    case BinaryOpType::REM:
+      return makeRealConstant(std::fmod(l, r));
+    case BinaryOpType::POWER:
+      if (right.kind == ConstantKind::Integer)
+        return makeRealConstant(realIntPower(l, right.intValue));
+      return makeRealConstant(std::pow(l, r));
+    default:
+      return foldComparison(op, l, r);
+    }
+  }
+
+  if (left.kind != right.kind)
+    return std::nullopt;
+  if (left.kind == ConstantKind::Character) {
+    if (op == BinaryOpType::EQUAL)
+      return makeBoolConstant(left.charValue == right.charValue);
+    if (op == BinaryOpType::NOT_EQUAL)
+      return makeBoolConstant(left.charValue != right.charValue);
+    return std::nullopt;
+  }
+  switch (op) {
+  case BinaryOpType::EQUAL:
+    return makeBoolConstant(left.boolValue == right.boolValue);
+  case BinaryOpType::NOT_EQUAL:
+  case BinaryOpType::XOR:
+    return makeBoolConstant(left.boolValue != right.boolValue);
+  case BinaryOpType::AND:
+    return makeBoolConstant(left.boolValue && right.boolValue);
+  case BinaryOpType::OR:
+    return makeBoolConstant(left.boolValue || right.boolValue);
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<ConstantValue> foldUnary(const ast::expressions::UnaryOpType op,
+                                       const ConstantValue &operand) {
+  switch (op) {
+  case ast::expressions::UnaryOpType::PLUS:
+    if (operand.kind == ConstantKind::Integer || operand.kind == ConstantKind::Real)
+      return operand;
+    return std::nullopt;
+  case ast::expressions::UnaryOpType::MINUS:
+    if (operand.kind == ConstantKind::Integer)
+      return makeIntConstant(wrap(-static_cast<int64_t>(operand.intValue)));
+    if (operand.kind == ConstantKind::Real)
+      return makeRealConstant(-operand.realValue);
+    return std::nullopt;
+  case ast::expressions::UnaryOpType::NOT:
+    if (operand.kind == ConstantKind::Boolean)
+      return makeBoolConstant(!operand.boolValue);
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+// Mirrors Backend::promoteScalarValue; real to integer is only folded when the truncated value fits
+// in an integer, anything else is left to the backend
+std::optional<ConstantValue> foldCast(const ConstantValue &value, const std::string &targetName) {
+  if (targetName == constantKindName(value.kind))
+    return value;
+  switch (value.kind) {
+  case ConstantKind::Integer:
+    if (targetName == "real")
+      return makeRealConstant(static_cast<float>(value.intValue));
+    if (targetName == "boolean")
+      return makeBoolConstant(value.intValue != 0);
+    if (targetName == "character")
+      return makeCharConstant(static_cast<char>(static_cast<uint8_t>(value.intValue)));
+    return std::nullopt;
+  case ConstantKind::Character: {
+    const auto code = static_cast<uint8_t>(value.charValue);
+    if (targetName == "integer")
+      return makeIntConstant(code);
+    if (targetName == "real")
+      return makeRealConstant(static_cast<float>(code));
+    if (targetName == "boolean")
+      return makeBoolConstant(code != 0);
+    return std::nullopt;
+  }
+  case ConstantKind::Boolean:
+    if (targetName == "integer")
+      return makeIntConstant(value.boolValue ? 1 : 0);
+    if (targetName == "real")
+      return makeRealConstant(value.boolValue ? 1.0f : 0.0f);
+    if (targetName == "character")
+      return makeCharConstant(value.boolValue ? 1 : 0);
+    return std::nullopt;
+  case ConstantKind::Real:
+    if (targetName == "integer" && !std::isnan(value.realValue) &&
+        value.realValue >= -2147483648.0f && value.realValue < 2147483648.0f)
+      return makeIntConstant(static_cast<int32_t>(value.realValue));
+    return std::nullopt;
+  }
+  return std::nullopt;
+}
+
+std::shared_ptr<ast::expressions::ExpressionAst>
+makeLiteral(const std::shared_ptr<symTable::SymbolTable> &symTab, const ConstantValue &value,
+            const std::shared_ptr<ast::expressions::ExpressionAst> &replaced) {
+  auto *token = replaced->token;
+  std::shared_ptr<ast::expressions::ExpressionAst> literal;
+  std::shared_ptr<ast::types::DataTypeAst> dataType;
+  switch (value.kind) {
+  case ConstantKind::Integer:
+    literal = std::make_shared<ast::expressions::IntegerLiteralAst>(token, value.intValue);
+    dataType = std::make_shared<ast::types::IntegerTypeAst>(token);
+    break;
+  case ConstantKind::Real:
+    literal = std::make_shared<ast::expressions::RealLiteralAst>(token, value.realValue);
+    dataType = std::make_shared<ast::types::RealTypeAst>(token);
+    break;
+  case ConstantKind::Character: {
+    auto charLiteral = std::make_shared<ast::expressions::CharLiteralAst>(token);
+    charLiteral->setValue(value.charValue);
+    literal = charLiteral;
+    dataType = std::make_shared<ast::types::CharacterTypeAst>(token);
+    break;
+  }
+  case ConstantKind::Boolean: {
+    auto boolLiteral = std::make_shared<ast::expressions::BoolLiteralAst>(token);
+    boolLiteral->setValue(value.boolValue);
+    literal = boolLiteral;
+    dataType = std::make_shared<ast::types::BooleanTypeAst>(token);
+    break;
+  }
+  }
+  literal->setScope(replaced->getScope());
+  literal->setInferredDataType(dataType);
+  literal->setInferredSymbolType(std::dynamic_pointer_cast<symTable::Type>(
+      symTab->getGlobalScope()->resolveType(constantKindName(value.kind))));
+  return literal;
+}
+
+bool matchesInferredType(const std::shared_ptr<ast::expressions::ExpressionAst> &expr,
+                         const ConstantValue &value) {
+  const auto inferredType = expr->getInferredSymbolType();
+  return inferredType && inferredType->getName() == constantKindName(value.kind);
+}
+
+} // namespace gazprea::utils
@@ -0,0 +1,68 @@
+#!/bin/bash
+
+# Compares the runtime of gazc output at -O0 against an optimized level.
+# Usage: tests/benchmarks/bench.sh [-O1|-O2|-O3] [files...]
+# Without files every benchmark in this directory plus the array/vector
+# binary-op tests is timed. Results are appended to bench_output.txt.
+# BASE_FLAGS replaces the -O0 baseline, e.g. compare the ** kernels against
+# inline loops with: BASE_FLAGS="-O2 --no-rt-kernels" bench.sh -O2 dot-*.in
+
+REPO_ROOT=$(git rev-parse --show-toplevel)
+GAZC="${REPO_ROOT}/bin/gazc"
+RT_DIR="${REPO_ROOT}/bin"
+LLC=${LLC:-llc}
+CC=${CC:-clang}
+RUNS=${RUNS:-5}
+BASE_FLAGS=${BASE_FLAGS:--O0}
+OUT="${REPO_ROOT}/bench_output.txt"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+OPT="-O2"
+if [[ "$1" == -O[0-3] ]]; then
+    OPT="$1"
+    shift
+fi
+
+FILES=("$@")
+if [ ${#FILES[@]} -eq 0 ]; then
+    FILES=("${REPO_ROOT}"/tests/benchmarks/*.in
+           "${REPO_ROOT}"/tests/testfiles/dragon-deez-nuts/binary-ops/array/*.in
+           "${REPO_ROOT}"/tests/testfiles/dragon-deez-nuts/binary-ops/vectors/*.in)
+fi
+
+# Builds $1 with the gazc flags in $2 into $WORK/$3, returns non-zero on failure.
+build() {
+    # shellcheck disable=SC2086 # $2 may hold several flags
+    "$GAZC" $2 "$1" "$WORK/$3.ll" > /dev/null 2>&1 &&
+        "$LLC" -filetype=obj -relocation-model=pic "$WORK/$3.ll" -o "$WORK/$3.o" &&
+        "$CC" "$WORK/$3.o" -o "$WORK/$3" -L"$RT_DIR" -lgazrt -lm
+}
+
+# Prints the total wall time in seconds of $RUNS executions of $1.
+time_runs() {
+    local start end
+    start=$(date +%s.%N)
+    for ((r = 0; r < RUNS; r++)); do
+        LD_LIBRARY_PATH="$RT_DIR" DYLD_LIBRARY_PATH="$RT_DIR" "$1" < /dev/null > /dev/null 2>&1
+    done
+    end=$(date +%s.%N)
+    echo "$end - $start" | bc
+}
+
+{
+    echo "== $(date) gazc ${BASE_FLAGS} vs ${OPT}, ${RUNS} runs each =="
+    printf "%-40s %10s %10s %8s\n" "test" "base (s)" "${OPT} (s)" "speedup"
+} | tee -a "$OUT"
+
+for file in "${FILES[@]}"; do
+    name=$(basename "$file" .in)
+    if ! build "$file" "$BASE_FLAGS" "${name}-base" || ! build "$file" "$OPT" "${name}-opt"; then
+        printf "%-40s %s\n" "$name" "build failed" | tee -a "$OUT"
+        continue
+    fi
+    base=$(time_runs "$WORK/${name}-base")
+    opt=$(time_runs "$WORK/${name}-opt")
+    speedup=$(echo "scale=2; $base / ($opt + 0.0001)" | bc)
+    printf "%-40s %10.4f %10.4f %7sx\n" "$name" "$base" "$opt" "$speedup" | tee -a "$OUT"
+done